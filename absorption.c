@@ -0,0 +1,405 @@
+#include "absorption.h"
+#include <math.h>
+
+static int compare_ints(const void *a, const void *b) {
+    int x = *(const int *) a, y = *(const int *) b;
+    return (x > y) - (x < y);
+}
+
+// Arêtes internes d'une classe, en index locaux (position dans vertex_ids), sans les boucles
+typedef struct s_class_block {
+    int size;                       // Nombre d'états de la classe
+    int *offsets;                   // size + 1 offsets
+    int *local_dest;                // Destination locale de chaque arête interne
+    double *proba;                  // Probabilité de chaque arête interne
+    double *self_loop;              // Probabilité de boucle de chaque état
+} t_class_block;
+
+static t_class_block build_class_block(t_adj_list *graph, t_classe *class, int class_index, const int *class_map, const int *local_index) {
+    t_class_block block;
+    block.size = class->vertex_count;
+    block.offsets = malloc((block.size + 1) * sizeof(int));
+    block.self_loop = calloc(block.size, sizeof(double));
+    if (block.offsets == NULL || block.self_loop == NULL) exit(EXIT_FAILURE);
+
+    int count = 0;
+    for (int q = 0; q < block.size; q++) {
+        int i = class->vertex_ids[q] - 1;
+        for (int e = graph->offsets[i]; e < graph->offsets[i + 1]; e++) {
+            if (class_map[graph->dest[e]] == class_index && graph->dest[e] != i) count++;
+        }
+    }
+
+    block.local_dest = malloc((count > 0 ? count : 1) * sizeof(int));
+    block.proba = malloc((count > 0 ? count : 1) * sizeof(double));
+    if (block.local_dest == NULL || block.proba == NULL) exit(EXIT_FAILURE);
+
+    count = 0;
+    for (int q = 0; q < block.size; q++) {
+        int i = class->vertex_ids[q] - 1;
+        block.offsets[q] = count;
+        for (int e = graph->offsets[i]; e < graph->offsets[i + 1]; e++) {
+            int j = graph->dest[e];
+            if (class_map[j] != class_index) continue;
+            if (j == i) {
+                block.self_loop[q] += graph->proba[e];
+            } else {
+                block.local_dest[count] = local_index[j];
+                block.proba[count] = graph->proba[e];
+                count++;
+            }
+        }
+    }
+    block.offsets[block.size] = count;
+    return block;
+}
+
+static void free_class_block(t_class_block *block) {
+    free(block->offsets);
+    free(block->local_dest);
+    free(block->proba);
+    free(block->self_loop);
+}
+
+// Ensembles des classes fermées atteignables, calculés dans l'ordre topologique inverse.
+// Renvoie false si leur taille totale dépasse ABSORPTION_MAX_VALUES.
+static bool compute_reach(t_absorption *absorption, t_link_array *link_array, const int *order, const bool *is_transient, const int *closed_index) {
+    int class_count = absorption->class_count;
+    int *child_offsets = calloc(class_count + 1, sizeof(int));
+    int *children = malloc((link_array->link_count > 0 ? link_array->link_count : 1) * sizeof(int));
+    int *begin = malloc((class_count > 0 ? class_count : 1) * sizeof(int));
+    int *count = malloc((class_count > 0 ? class_count : 1) * sizeof(int));
+    int *stamp = malloc((absorption->closed_count > 0 ? absorption->closed_count : 1) * sizeof(int));
+    if (child_offsets == NULL || children == NULL || begin == NULL || count == NULL || stamp == NULL) exit(EXIT_FAILURE);
+
+    for (int i = 0; i < link_array->link_count; i++) {
+        child_offsets[link_array->links[i].class_from + 1]++;
+    }
+    for (int c = 0; c < class_count; c++) {
+        child_offsets[c + 1] += child_offsets[c];
+    }
+    int *cursor = malloc((class_count > 0 ? class_count : 1) * sizeof(int));
+    if (cursor == NULL) exit(EXIT_FAILURE);
+    memcpy(cursor, child_offsets, class_count * sizeof(int));
+    for (int i = 0; i < link_array->link_count; i++) {
+        children[cursor[link_array->links[i].class_from]++] = link_array->links[i].class_dest;
+    }
+    free(cursor);
+
+    for (int k = 0; k < absorption->closed_count; k++) {
+        stamp[k] = -1;
+    }
+
+    // Tampon temporaire, rangé dans l'ordre de traitement, puis recopié dans l'ordre des classes
+    long long capacity = class_count > 0 ? class_count : 1, used = 0;
+    bool fits = true;
+    int *buffer = malloc(capacity * sizeof(int));
+    if (buffer == NULL) exit(EXIT_FAILURE);
+
+    for (int t = class_count - 1; t >= 0 && fits; t--) {
+        int c = order[t];
+        begin[c] = used;
+
+        if (!is_transient[c]) {
+            if (used == capacity) {
+                capacity *= 2;
+                buffer = realloc(buffer, capacity * sizeof(int));
+                if (buffer == NULL) exit(EXIT_FAILURE);
+            }
+            buffer[used++] = closed_index[c];
+        } else {
+            for (int i = child_offsets[c]; i < child_offsets[c + 1] && fits; i++) {
+                int d = children[i];
+                if (d == c) continue;
+                if (used + count[d] > ABSORPTION_MAX_VALUES) {
+                    fits = false;
+                    break;
+                }
+                for (int r = begin[d]; r < begin[d] + count[d]; r++) {
+                    int k = buffer[r];
+                    if (stamp[k] == c) continue;
+                    stamp[k] = c;
+                    if (used == capacity) {
+                        capacity *= 2;
+                        buffer = realloc(buffer, capacity * sizeof(int));
+                        if (buffer == NULL) exit(EXIT_FAILURE);
+                    }
+                    buffer[used++] = k;
+                }
+            }
+            qsort(buffer + begin[c], used - begin[c], sizeof(int), compare_ints);
+        }
+        count[c] = used - begin[c];
+    }
+
+    if (!fits) {
+        free(buffer);
+        free(stamp);
+        free(count);
+        free(begin);
+        free(children);
+        free(child_offsets);
+        return false;
+    }
+
+    absorption->reach_offsets = malloc((class_count + 1) * sizeof(int));
+    absorption->reach = malloc((used > 0 ? used : 1) * sizeof(int));
+    if (absorption->reach_offsets == NULL || absorption->reach == NULL) exit(EXIT_FAILURE);
+
+    absorption->reach_offsets[0] = 0;
+    for (int c = 0; c < class_count; c++) {
+        memcpy(absorption->reach + absorption->reach_offsets[c], buffer + begin[c], count[c] * sizeof(int));
+        absorption->reach_offsets[c + 1] = absorption->reach_offsets[c] + count[c];
+    }
+
+    free(buffer);
+    free(stamp);
+    free(count);
+    free(begin);
+    free(children);
+    free(child_offsets);
+    return true;
+}
+
+t_absorption compute_absorption(t_adj_list *graph, t_partition *partition, int *class_map, t_link_array *link_array, double tolerance, int max_sweeps) {
+    int length = graph->length;
+    int class_count = partition->class_count;
+
+    t_absorption absorption;
+    absorption.length = length;
+    absorption.class_count = class_count;
+    absorption.sweeps = 0;
+    absorption.residual = 0.0;
+    absorption.converged = true;
+
+    absorption.class_map = malloc((length > 0 ? length : 1) * sizeof(int));
+    if (absorption.class_map == NULL) exit(EXIT_FAILURE);
+    memcpy(absorption.class_map, class_map, length * sizeof(int));
+
+    bool *is_transient = find_transient_classes(partition, link_array);
+    int *order = topological_sort_classes(link_array, class_count);
+    int *closed_index = malloc((class_count > 0 ? class_count : 1) * sizeof(int));
+    absorption.closed_classes = malloc((class_count > 0 ? class_count : 1) * sizeof(int));
+    if (order == NULL || closed_index == NULL || absorption.closed_classes == NULL) exit(EXIT_FAILURE);
+
+    absorption.closed_count = 0;
+    for (int c = 0; c < class_count; c++) {
+        closed_index[c] = -1;
+        if (!is_transient[c]) {
+            closed_index[c] = absorption.closed_count;
+            absorption.closed_classes[absorption.closed_count++] = c;
+        }
+    }
+
+    absorption.reach_offsets = NULL;
+    absorption.reach = NULL;
+    absorption.value_offsets = NULL;
+    absorption.probabilities = NULL;
+    absorption.expected_steps = NULL;
+    bool fits = compute_reach(&absorption, link_array, order, is_transient, closed_index);
+
+    // Emplacement des probabilités : une par classe fermée atteignable, pour chaque état
+    int *local_index = malloc((length > 0 ? length : 1) * sizeof(int));
+    if (fits) absorption.value_offsets = malloc((length > 0 ? length : 1) * sizeof(long long));
+    if (local_index == NULL || (fits && absorption.value_offsets == NULL)) exit(EXIT_FAILURE);
+
+    long long value_count = 0;
+    for (int c = 0; c < class_count && fits; c++) {
+        t_classe *class = &partition->classes[c];
+        int reach_count = absorption.reach_offsets[c + 1] - absorption.reach_offsets[c];
+        for (int q = 0; q < class->vertex_count; q++) {
+            int i = class->vertex_ids[q] - 1;
+            local_index[i] = q;
+            absorption.value_offsets[i] = value_count;
+            value_count += reach_count;
+        }
+        if (value_count > ABSORPTION_MAX_VALUES) fits = false;
+    }
+
+    // Trop de couples (état, classe fermée atteignable) : rien n'est calculé
+    if (!fits) {
+        free(absorption.reach_offsets);
+        free(absorption.reach);
+        free(absorption.value_offsets);
+        absorption.reach_offsets = NULL;
+        absorption.reach = NULL;
+        absorption.value_offsets = NULL;
+        absorption.converged = false;
+        free(local_index);
+        free(closed_index);
+        free(order);
+        free(is_transient);
+        return absorption;
+    }
+
+    absorption.probabilities = calloc(value_count > 0 ? value_count : 1, sizeof(double));
+    absorption.expected_steps = calloc(length > 0 ? length : 1, sizeof(double));
+    int *position = malloc((absorption.closed_count > 0 ? absorption.closed_count : 1) * sizeof(int));
+    if (absorption.probabilities == NULL || absorption.expected_steps == NULL || position == NULL) exit(EXIT_FAILURE);
+
+    // États des classes fermées : absorbés sur place
+    for (int i = 0; i < length; i++) {
+        if (!is_transient[class_map[i]]) absorption.probabilities[absorption.value_offsets[i]] = 1.0;
+    }
+    for (int k = 0; k < absorption.closed_count; k++) {
+        position[k] = -1;
+    }
+
+    // Classes transitoires, de l'aval vers l'amont
+    for (int t = class_count - 1; t >= 0; t--) {
+        int c = order[t];
+        if (!is_transient[c]) continue;
+
+        t_classe *class = &partition->classes[c];
+        const int *reach = absorption.reach + absorption.reach_offsets[c];
+        int reach_count = absorption.reach_offsets[c + 1] - absorption.reach_offsets[c];
+        for (int r = 0; r < reach_count; r++) {
+            position[reach[r]] = r;
+        }
+
+        // Une ligne par état : les probabilités vers chaque classe atteignable, puis la durée
+        // (rangées ensemble pour qu'un voisin ne coûte qu'un accès mémoire par balayage)
+        int size = class->vertex_count;
+        int width = reach_count + 1;
+        double *constant = calloc((size_t) size * width, sizeof(double));
+        double *rows = calloc((size_t) size * width, sizeof(double));
+        double *sums = malloc(width * sizeof(double));
+        if (constant == NULL || rows == NULL || sums == NULL) exit(EXIT_FAILURE);
+
+        // Partie constante : 1 pas + contributions des états en aval (déjà résolus)
+        for (int q = 0; q < size; q++) {
+            int i = class->vertex_ids[q] - 1;
+            double *row = constant + (size_t) q * width;
+            row[reach_count] = 1.0;
+            for (int e = graph->offsets[i]; e < graph->offsets[i + 1]; e++) {
+                int j = graph->dest[e];
+                int d = class_map[j];
+                double p = graph->proba[e];
+                if (d == c) continue;
+
+                row[reach_count] += p * absorption.expected_steps[j];
+                const double *values = absorption.probabilities + absorption.value_offsets[j];
+                for (int r = absorption.reach_offsets[d]; r < absorption.reach_offsets[d + 1]; r++) {
+                    row[position[absorption.reach[r]]] += p * values[r - absorption.reach_offsets[d]];
+                }
+            }
+        }
+
+        // Gauss-Seidel sur les arêtes internes : x_i = (constante_i + somme p_ij x_j) / (1 - p_ii)
+        t_class_block block = build_class_block(graph, class, c, class_map, local_index);
+        double change = INFINITY;
+        int sweep = 0;
+        while (sweep < max_sweeps) {
+            change = 0.0;
+            for (int q = 0; q < size; q++) {
+                memcpy(sums, constant + (size_t) q * width, width * sizeof(double));
+                for (int e = block.offsets[q]; e < block.offsets[q + 1]; e++) {
+                    double p = block.proba[e];
+                    const double *neighbour = rows + (size_t) block.local_dest[e] * width;
+                    for (int r = 0; r < width; r++) sums[r] += p * neighbour[r];
+                }
+
+                double scale = 1.0 / (1.0 - block.self_loop[q]);
+                double *own = rows + (size_t) q * width;
+                for (int r = 0; r < reach_count; r++) {
+                    double value = sums[r] * scale;
+                    if (fabs(value - own[r]) > change) change = fabs(value - own[r]);
+                    own[r] = value;
+                }
+                // Variation relative pour la durée, qui peut être grande
+                double steps = sums[reach_count] * scale;
+                double relative = fabs(steps - own[reach_count]) / (steps > 1.0 ? steps : 1.0);
+                if (relative > change) change = relative;
+                own[reach_count] = steps;
+            }
+            sweep++;
+
+            // Sans arête interne, un balayage donne la solution exacte
+            if (block.offsets[size] == 0) {
+                change = 0.0;
+                break;
+            }
+            if (change <= tolerance) break;
+        }
+
+        // Les états d'une classe sont consécutifs dans probabilities
+        double *values = absorption.probabilities + absorption.value_offsets[class->vertex_ids[0] - 1];
+        for (int q = 0; q < size; q++) {
+            memcpy(values + (size_t) q * reach_count, rows + (size_t) q * width, reach_count * sizeof(double));
+            absorption.expected_steps[class->vertex_ids[q] - 1] = rows[(size_t) q * width + reach_count];
+        }
+        absorption.sweeps += sweep;
+        if (change > absorption.residual) absorption.residual = change;
+        if (change > tolerance) absorption.converged = false;
+
+        for (int r = 0; r < reach_count; r++) {
+            position[reach[r]] = -1;
+        }
+        free(sums);
+        free_class_block(&block);
+        free(rows);
+        free(constant);
+    }
+
+    free(position);
+    free(local_index);
+    free(closed_index);
+    free(order);
+    free(is_transient);
+    return absorption;
+}
+
+double absorption_probability(const t_absorption *absorption, int state, int closed_index) {
+    if (absorption->probabilities == NULL) return 0.0;
+    int c = absorption->class_map[state];
+    const int *reach = absorption->reach + absorption->reach_offsets[c];
+    int low = 0, high = absorption->reach_offsets[c + 1] - absorption->reach_offsets[c];
+
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        if (reach[mid] < closed_index) low = mid + 1;
+        else high = mid;
+    }
+    if (low < absorption->reach_offsets[c + 1] - absorption->reach_offsets[c] && reach[low] == closed_index) {
+        return absorption->probabilities[absorption->value_offsets[state] + low];
+    }
+    return 0.0;
+}
+
+void display_absorption(const t_absorption *absorption, t_partition *partition, int max_states) {
+    if (absorption->probabilities == NULL) {
+        printf("%d classe(s) fermee(s) : plus de %d probabilites d'absorption a stocker, calcul abandonne.\n",
+               absorption->closed_count, ABSORPTION_MAX_VALUES);
+        return;
+    }
+    printf("%d classe(s) fermee(s), %d balayage(s) de Gauss-Seidel (variation max %.3e)%s.\n",
+           absorption->closed_count, absorption->sweeps, absorption->residual,
+           absorption->converged ? "" : ", sans convergence");
+
+    int shown = 0;
+    for (int i = 0; i < absorption->length && shown < max_states; i++) {
+        // Les états des classes fermées (durée nulle) ne sont pas affichés
+        if (absorption->expected_steps[i] == 0.0) continue;
+        int c = absorption->class_map[i];
+
+        printf("  Etat %d : duree moyenne %.4f pas ;", i + 1, absorption->expected_steps[i]);
+        for (int r = absorption->reach_offsets[c]; r < absorption->reach_offsets[c + 1]; r++) {
+            int closed_class = absorption->closed_classes[absorption->reach[r]];
+            printf(" %s %.6f", partition->classes[closed_class].name,
+                   absorption->probabilities[absorption->value_offsets[i] + r - absorption->reach_offsets[c]]);
+        }
+        printf("\n");
+        shown++;
+    }
+}
+
+void free_absorption(t_absorption *absorption) {
+    free(absorption->closed_classes);
+    free(absorption->class_map);
+    free(absorption->reach_offsets);
+    free(absorption->reach);
+    free(absorption->value_offsets);
+    free(absorption->probabilities);
+    free(absorption->expected_steps);
+    absorption->length = 0;
+}
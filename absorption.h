@@ -0,0 +1,72 @@
+#ifndef __ABSORPTION_H__
+#define __ABSORPTION_H__
+
+#include "utils.h"
+#include "hasse.h"
+
+#define ABSORPTION_TOLERANCE 1e-12          // Seuil par défaut sur la plus grande variation d'un balayage
+#define ABSORPTION_MAX_SWEEPS 100000        // Nombre maximal de balayages par classe transitoire
+#define ABSORPTION_MAX_VALUES (1 << 27)     // Nombre maximal de probabilités stockées (1 Gio en double)
+
+// Probabilités d'absorption et durées moyennes avant absorption d'une chaîne.
+// Chaque classe ne stocke que les classes fermées qu'elle peut atteindre : l'état i a une
+// probabilité par classe de reach[reach_offsets[c] .. reach_offsets[c + 1]), c = class_map[i],
+// rangées à partir de probabilities[value_offsets[i]].
+typedef struct s_absorption {
+    int length;                     // Nombre d'états
+    int class_count;                // Nombre de classes de la partition
+    int closed_count;               // Nombre de classes fermées (persistantes)
+    int *closed_classes;            // Index dans la partition de chaque classe fermée
+    int *class_map;                 // Copie du mappage sommet -> classe
+    int *reach_offsets;             // class_count + 1 offsets dans reach
+    int *reach;                     // Classes fermées atteignables (index 0..closed_count-1, croissants)
+    long long *value_offsets;       // Début des probabilités de chaque état
+    double *probabilities;          // Probabilités d'absorption
+    double *expected_steps;         // Nombre moyen de pas avant d'entrer dans une classe fermée (0 si fermée)
+    int sweeps;                     // Nombre total de balayages de Gauss-Seidel
+    double residual;                // Plus grande variation au dernier balayage de chaque classe
+    bool converged;                 // true si toutes les classes ont convergé
+} t_absorption;
+
+/**
+ * @brief Calcule, pour chaque état, la probabilité de finir dans chaque classe fermée et le
+ * nombre moyen de pas avant d'y entrer, sans matrice fondamentale dense.
+ * Les classes transitoires sont traitées dans l'ordre topologique inverse : les valeurs des
+ * classes en aval sont alors connues, et seules les arêtes internes à la classe demandent des
+ * balayages de Gauss-Seidel (un seul balayage exact pour une classe d'un état). Mémoire et travail
+ * par balayage en O(V + E) fois le nombre de classes fermées atteignables.
+ * @param graph Pointeur vers le graphe.
+ * @param partition Pointeur vers la partition (tarjan ou find_scc).
+ * @param class_map Tableau de mappage sommet->classe (create_class_map).
+ * @param link_array Pointeur vers les liens entre classes (find_class_links).
+ * @param tolerance Seuil d'arrêt sur la plus grande variation d'un balayage.
+ * @param max_sweeps Nombre maximal de balayages par classe.
+ * @return Le résultat (à libérer avec free_absorption) ; probabilities vaut NULL si plus de
+ * ABSORPTION_MAX_VALUES probabilités seraient à stocker (nombreuses classes fermées atteignables).
+ */
+t_absorption compute_absorption(t_adj_list *graph, t_partition *partition, int *class_map, t_link_array *link_array, double tolerance, int max_sweeps);
+
+/**
+ * @brief Donne la probabilité de finir dans une classe fermée depuis un état.
+ * @param absorption Pointeur vers le résultat.
+ * @param state L'état (index à partir de 0).
+ * @param closed_index L'index de la classe fermée (0..closed_count-1).
+ * @return La probabilité (0 si la classe n'est pas atteignable).
+ */
+double absorption_probability(const t_absorption *absorption, int state, int closed_index);
+
+/**
+ * @brief Affiche les probabilités d'absorption et les durées moyennes des états transitoires.
+ * @param absorption Pointeur vers le résultat.
+ * @param partition Pointeur vers la partition (noms des classes).
+ * @param max_states Nombre maximal d'états affichés.
+ */
+void display_absorption(const t_absorption *absorption, t_partition *partition, int max_states);
+
+/**
+ * @brief Libère le résultat.
+ * @param absorption Pointeur vers le résultat.
+ */
+void free_absorption(t_absorption *absorption);
+
+#endif // __ABSORPTION_H__
@@ -0,0 +1,128 @@
+#include "binary.h"
+#include "parser.h"
+
+#define FNV_OFFSET_BASIS 14695981039346656037ULL
+#define FNV_PRIME 1099511628211ULL
+
+static uint64_t checksum_words(uint64_t hash, const void *data, size_t word_count) {
+    const uint32_t *words = data;
+
+    for (size_t i = 0; i < word_count; i++) {
+        hash ^= words[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+uint64_t graph_checksum(const t_adj_list *graph) {
+    uint64_t hash = FNV_OFFSET_BASIS;
+    hash = checksum_words(hash, graph->offsets, (size_t) graph->length + 1);
+    hash = checksum_words(hash, graph->dest, (size_t) graph->edge_count);
+    hash = checksum_words(hash, graph->proba, (size_t) graph->edge_count);
+    return hash;
+}
+
+int write_binary_graph(const t_adj_list *graph, const char *filename) {
+    FILE *file = fopen(filename, "wb");
+    if (file == NULL) return -1;
+
+    t_binary_header header;
+    memcpy(header.magic, BINARY_GRAPH_MAGIC, 4);
+    header.version = BINARY_GRAPH_VERSION;
+    header.endian_mark = BINARY_GRAPH_ENDIAN_MARK;
+    header.vertex_count = graph->length;
+    header.edge_count = graph->edge_count;
+    header.checksum = graph_checksum(graph);
+
+    size_t edge_count = (size_t) graph->edge_count;
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1
+           && fwrite(graph->offsets, sizeof(int32_t), (size_t) graph->length + 1, file) == (size_t) graph->length + 1
+           && fwrite(graph->dest, sizeof(int32_t), edge_count, file) == edge_count
+           && fwrite(graph->proba, sizeof(float), edge_count, file) == edge_count;
+
+    if (fclose(file) != 0) ok = false;
+    return ok ? 0 : -1;
+}
+
+static void exit_on_binary_error(const char *filename, t_mapped_file *file, const char *message) {
+    fprintf(stderr, "%s : %s\n", filename, message);
+    unmap_file(file);
+    exit(EXIT_FAILURE);
+}
+
+t_adj_list load_binary_graph(const char *filename, bool verify) {
+    t_mapped_file *file = malloc(sizeof(t_mapped_file));
+    if (file == NULL) exit(EXIT_FAILURE);
+
+    if (map_file(filename, file) != 0) {
+        perror("Le fichier n'a pas pu etre ouvert");
+        exit(EXIT_FAILURE);
+    }
+
+    t_binary_header header;
+    if (file->size < sizeof(header)) exit_on_binary_error(filename, file, "en-tete binaire tronque");
+    memcpy(&header, file->data, sizeof(header));
+
+    if (memcmp(header.magic, BINARY_GRAPH_MAGIC, 4) != 0) exit_on_binary_error(filename, file, "ce n'est pas un graphe binaire");
+    if (header.endian_mark != BINARY_GRAPH_ENDIAN_MARK) exit_on_binary_error(filename, file, "boutisme incompatible");
+    if (header.version != BINARY_GRAPH_VERSION) exit_on_binary_error(filename, file, "version du format non supportee");
+    if (header.vertex_count < 1 || header.edge_count < 0 || header.edge_count > INT32_MAX) {
+        exit_on_binary_error(filename, file, "en-tete binaire invalide");
+    }
+
+    size_t offsets_size = ((size_t) header.vertex_count + 1) * sizeof(int32_t);
+    size_t dest_size = (size_t) header.edge_count * sizeof(int32_t);
+    size_t proba_size = (size_t) header.edge_count * sizeof(float);
+    if (file->size != sizeof(header) + offsets_size + dest_size + proba_size) {
+        exit_on_binary_error(filename, file, "taille de fichier incoherente avec l'en-tete");
+    }
+
+    // Les tableaux pointent directement dans la projection : aucune copie
+    t_adj_list graph;
+    graph.length = header.vertex_count;
+    graph.edge_count = (int) header.edge_count;
+    graph.offsets = (int *) (file->data + sizeof(header));
+    graph.dest = (int *) (file->data + sizeof(header) + offsets_size);
+    graph.proba = (float *) (file->data + sizeof(header) + offsets_size + dest_size);
+    graph.storage = file;
+
+    if (graph.offsets[0] != 0 || graph.offsets[graph.length] != graph.edge_count) {
+        exit_on_binary_error(filename, file, "offsets de lignes invalides");
+    }
+
+    // Offsets croissants et destinations dans [0, V) : toute arête lue plus tard reste dans le graphe
+    for (int i = 0; i < graph.length; i++) {
+        if (graph.offsets[i] > graph.offsets[i + 1]) exit_on_binary_error(filename, file, "offsets de lignes non croissants");
+    }
+    for (int e = 0; e < graph.edge_count; e++) {
+        if ((unsigned int) graph.dest[e] >= (unsigned int) graph.length) exit_on_binary_error(filename, file, "sommet de destination invalide");
+    }
+
+    if (verify && graph_checksum(&graph) != header.checksum) exit_on_binary_error(filename, file, "somme de controle invalide");
+
+    return graph;
+}
+
+bool is_binary_graph_file(const char *filename) {
+    FILE *file = fopen(filename, "rb");
+    if (file == NULL) return false;
+
+    char magic[4];
+    bool is_binary = fread(magic, 1, 4, file) == 4 && memcmp(magic, BINARY_GRAPH_MAGIC, 4) == 0;
+    fclose(file);
+    return is_binary;
+}
+
+t_adj_list load_graph(const char *filename, bool verify) {
+    if (is_binary_graph_file(filename)) {
+        return load_binary_graph(filename, verify);
+    }
+    return read_graph(filename);
+}
+
+int convert_text_to_binary(const char *text_filename, const char *binary_filename) {
+    t_adj_list graph = read_graph(text_filename);
+    int status = write_binary_graph(&graph, binary_filename);
+    free_adjlist(&graph);
+    return status;
+}
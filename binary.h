@@ -0,0 +1,71 @@
+#ifndef __BINARY_H__
+#define __BINARY_H__
+
+#include <stdint.h>
+#include "utils.h"
+
+#define BINARY_GRAPH_MAGIC "MKVB"
+#define BINARY_GRAPH_VERSION 1
+#define BINARY_GRAPH_ENDIAN_MARK 0x01020304u
+
+// En-tête du format binaire (32 octets, little-endian). Il est suivi de :
+//   int32 offsets[vertex_count + 1], int32 dest[edge_count], float proba[edge_count]
+typedef struct s_binary_header {
+    char magic[4];              // "MKVB"
+    uint32_t version;           // Version du format (BINARY_GRAPH_VERSION)
+    uint32_t endian_mark;       // BINARY_GRAPH_ENDIAN_MARK, pour détecter un boutisme différent
+    int32_t vertex_count;       // Nombre de sommets
+    int64_t edge_count;         // Nombre d'arêtes
+    uint64_t checksum;          // Somme de contrôle FNV-1a (mots de 32 bits) des trois tableaux
+} t_binary_header;
+
+/**
+ * @brief Calcule la somme de contrôle des tableaux d'un graphe (FNV-1a sur des mots de 32 bits).
+ * @param graph Pointeur vers le graphe.
+ * @return La somme de contrôle.
+ */
+uint64_t graph_checksum(const t_adj_list *graph);
+
+/**
+ * @brief Écrit un graphe au format binaire.
+ * @param graph Pointeur vers le graphe.
+ * @param filename Le chemin du fichier à créer.
+ * @return 0 en cas de succès, -1 sinon.
+ */
+int write_binary_graph(const t_adj_list *graph, const char *filename);
+
+/**
+ * @brief Charge un graphe binaire par projection mémoire, sans copie.
+ * Les tableaux du graphe pointent dans la projection et sont en lecture seule.
+ * Les offsets et les destinations sont toujours vérifiés (O(V + E), une seule lecture des destinations).
+ * @param filename Le chemin du fichier binaire.
+ * @param verify true pour vérifier aussi la somme de contrôle (lecture de tous les tableaux).
+ * @return Le graphe chargé ; le programme s'arrête si le fichier est invalide.
+ */
+t_adj_list load_binary_graph(const char *filename, bool verify);
+
+/**
+ * @brief Indique si un fichier commence par l'en-tête du format binaire.
+ * @param filename Le chemin du fichier.
+ * @return true si le fichier est au format binaire.
+ */
+bool is_binary_graph_file(const char *filename);
+
+/**
+ * @brief Charge un graphe au format binaire ou texte, selon le contenu du fichier.
+ * @param filename Le chemin du fichier.
+ * @param verify true pour vérifier la somme de contrôle d'un graphe binaire (voir load_binary_graph) ;
+ * un fichier texte est toujours entièrement vérifié à la lecture.
+ * @return Le graphe chargé.
+ */
+t_adj_list load_graph(const char *filename, bool verify);
+
+/**
+ * @brief Convertit un fichier texte (format de read_graph) en fichier binaire.
+ * @param text_filename Le fichier texte source.
+ * @param binary_filename Le fichier binaire à créer.
+ * @return 0 en cas de succès, -1 sinon.
+ */
+int convert_text_to_binary(const char *text_filename, const char *binary_filename);
+
+#endif // __BINARY_H__
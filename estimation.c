@@ -0,0 +1,488 @@
+#include "estimation.h"
+#include "threads.h"
+
+#define ESTIMATION_EMPTY_KEY UINT64_MAX
+#define ESTIMATION_INITIAL_CAPACITY 16
+
+static bool is_separator(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == ',';
+}
+
+static uint64_t transition_key(int from, int to) {
+    return (uint64_t) from << 32 | (uint32_t) to;
+}
+
+// Fragment d'un état de départ : les identifiants étant denses, les bits bas suffisent à répartir les lignes
+static int shard_of(int from) {
+    return from & (ESTIMATION_SHARDS - 1);
+}
+
+static void init_count_map(t_count_map *map, int capacity) {
+    map->capacity = capacity;
+    map->count = 0;
+    map->keys = malloc(capacity * sizeof(uint64_t));
+    map->counts = malloc(capacity * sizeof(long long));
+    if (map->keys == NULL || map->counts == NULL) exit(EXIT_FAILURE);
+    for (int k = 0; k < capacity; k++) {
+        map->keys[k] = ESTIMATION_EMPTY_KEY;
+    }
+}
+
+static void free_count_map(t_count_map *map) {
+    free(map->keys);
+    free(map->counts);
+    map->keys = NULL;
+    map->counts = NULL;
+    map->capacity = 0;
+    map->count = 0;
+}
+
+// Case de la clé, ou case vide où l'insérer (hachage multiplicatif de Fibonacci)
+static int find_slot(const t_count_map *map, uint64_t key) {
+    int mask = map->capacity - 1;
+    int slot = (int) ((key * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+    while (map->keys[slot] != key && map->keys[slot] != ESTIMATION_EMPTY_KEY) {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+static void add_count(t_count_map *map, uint64_t key, long long count);
+
+// Double la capacité quand la table est à moitié pleine
+static void grow_count_map(t_count_map *map) {
+    t_count_map grown;
+    init_count_map(&grown, map->capacity * 2);
+    for (int k = 0; k < map->capacity; k++) {
+        if (map->keys[k] != ESTIMATION_EMPTY_KEY) add_count(&grown, map->keys[k], map->counts[k]);
+    }
+    free_count_map(map);
+    *map = grown;
+}
+
+static void add_count(t_count_map *map, uint64_t key, long long count) {
+    int slot = find_slot(map, key);
+    if (map->keys[slot] == key) {
+        map->counts[slot] += count;
+        return;
+    }
+    map->keys[slot] = key;
+    map->counts[slot] = count;
+    map->count++;
+    if (map->count * 2 > map->capacity) grow_count_map(map);
+}
+
+t_estimator create_estimator(int length) {
+    t_estimator estimator;
+    estimator.length = length > 0 ? length : 0;
+    estimator.fixed_length = length > 0;
+    estimator.sequences = 0;
+    estimator.transitions = 0;
+    estimator.unobserved_states = 0;
+    for (int s = 0; s < ESTIMATION_SHARDS; s++) {
+        init_count_map(&estimator.shards[s], ESTIMATION_INITIAL_CAPACITY);
+    }
+    return estimator;
+}
+
+void estimator_add_sequence(t_estimator *estimator, const int *states, int count) {
+    if (count <= 0) return;
+    for (int t = 0; t < count; t++) {
+        if (states[t] < 0 || (estimator->fixed_length && states[t] >= estimator->length)) {
+            fprintf(stderr, "Etat %d hors de l'intervalle [1, %d].\n", states[t] + 1, estimator->length);
+            exit(EXIT_FAILURE);
+        }
+        if (!estimator->fixed_length && states[t] >= estimator->length) estimator->length = states[t] + 1;
+        if (t > 0) add_count(&estimator->shards[shard_of(states[t - 1])], transition_key(states[t - 1], states[t]), 1);
+    }
+    estimator->sequences++;
+    estimator->transitions += count - 1;
+}
+
+// Morceau d'un lot compté par un thread, dans ses propres tables
+typedef struct s_sequence_chunk {
+    const char *begin;              // Début du morceau (début de ligne)
+    const char *end;                // Fin du morceau (après un '\n' ou fin du lot)
+    t_count_map shards[ESTIMATION_SHARDS]; // Comptes du morceau, par fragment
+    long lines;                     // Nombre de lignes parcourues
+    long long sequences;            // Séquences lues
+    long long transitions;          // Transitions lues
+    int max_state;                  // Plus grand état rencontré (index à partir de 0, -1 si aucun)
+    int status;                     // 0 si succès, -1 si erreur
+    t_parse_error error;            // Erreur (numéro de ligne relatif au morceau)
+} t_sequence_chunk;
+
+typedef struct s_sequence_context {
+    t_sequence_chunk *chunks;
+    int chunk_count;
+    int length;                     // Borne des identifiants (0 : aucune)
+    t_estimator *estimator;
+} t_sequence_context;
+
+static void set_chunk_error(t_sequence_chunk *chunk, const char *message) {
+    chunk->status = -1;
+    chunk->error.line = chunk->lines;
+    snprintf(chunk->error.message, sizeof(chunk->error.message), "%s", message);
+}
+
+static void count_chunk_task(void *context, int chunk_index) {
+    t_sequence_context *ctx = context;
+    t_sequence_chunk *chunk = &ctx->chunks[chunk_index];
+    for (int s = 0; s < ESTIMATION_SHARDS; s++) {
+        init_count_map(&chunk->shards[s], ESTIMATION_INITIAL_CAPACITY);
+    }
+    chunk->lines = 0;
+    chunk->sequences = 0;
+    chunk->transitions = 0;
+    chunk->max_state = -1;
+    chunk->status = 0;
+
+    const char *p = chunk->begin, *end = chunk->end;
+    int previous = -1;
+    while (p < end) {
+        if (is_separator(*p)) {
+            p++;
+            continue;
+        }
+        if (*p == '\n') {
+            if (previous >= 0) chunk->sequences++;
+            previous = -1;
+            chunk->lines++;
+            p++;
+            continue;
+        }
+
+        int state;
+        if (!parse_int_token(&p, end, &state) || (p < end && !is_separator(*p) && *p != '\n')) {
+            set_chunk_error(chunk, "identifiant d'etat invalide");
+            return;
+        }
+        if (state < 1 || (ctx->length > 0 && state > ctx->length)) {
+            set_chunk_error(chunk, "identifiant d'etat hors de l'intervalle [1, nbvert]");
+            return;
+        }
+        state--;
+        if (state > chunk->max_state) chunk->max_state = state;
+
+        if (previous >= 0) {
+            add_count(&chunk->shards[shard_of(previous)], transition_key(previous, state), 1);
+            chunk->transitions++;
+        }
+        previous = state;
+    }
+    if (previous >= 0) chunk->sequences++;
+}
+
+// Fusion du fragment s de chaque morceau dans le fragment s de l'estimateur (sans verrou)
+static void merge_shard_task(void *context, int shard) {
+    t_sequence_context *ctx = context;
+    t_count_map *target = &ctx->estimator->shards[shard];
+    for (int c = 0; c < ctx->chunk_count; c++) {
+        t_count_map *source = &ctx->chunks[c].shards[shard];
+        for (int k = 0; k < source->capacity; k++) {
+            if (source->keys[k] != ESTIMATION_EMPTY_KEY) add_count(target, source->keys[k], source->counts[k]);
+        }
+        free_count_map(source);
+    }
+}
+
+int estimator_add_buffer(t_estimator *estimator, const char *data, const char *end, long *line, t_parse_error *error) {
+    // Découpage en morceaux alignés sur les fins de ligne, un par thread, comme read_graph
+    t_thread_pool *pool = pool_for_work((long) ((end - data) / 8));
+    int chunk_count = pool != NULL ? pool->thread_count : 1;
+
+    t_sequence_chunk *chunks = malloc(chunk_count * sizeof(t_sequence_chunk));
+    if (chunks == NULL) exit(EXIT_FAILURE);
+
+    const char *chunk_begin = data;
+    for (int c = 0; c < chunk_count; c++) {
+        const char *chunk_end = data + (end - data) * (c + 1) / chunk_count;
+        if (chunk_end < chunk_begin) chunk_end = chunk_begin;
+        if (c == chunk_count - 1) chunk_end = end;
+
+        const char *newline = chunk_end < end ? memchr(chunk_end, '\n', end - chunk_end) : NULL;
+        if (c < chunk_count - 1) chunk_end = newline != NULL ? newline + 1 : end;
+
+        chunks[c].begin = chunk_begin;
+        chunks[c].end = chunk_end;
+        chunk_begin = chunk_end;
+    }
+
+    t_sequence_context ctx = {
+        .chunks = chunks, .chunk_count = chunk_count,
+        .length = estimator->fixed_length ? estimator->length : 0, .estimator = estimator
+    };
+    run_parallel(pool, chunk_count, count_chunk_task, &ctx);
+
+    // Le numéro de ligne d'une erreur est relatif à son morceau : on y ajoute les lignes des morceaux précédents
+    long lines = *line;
+    int failed_chunk = -1;
+    for (int c = 0; c < chunk_count && failed_chunk == -1; c++) {
+        if (chunks[c].status != 0) {
+            failed_chunk = c;
+            *error = chunks[c].error;
+            error->line += lines;
+        } else {
+            lines += chunks[c].lines;
+        }
+    }
+
+    if (failed_chunk != -1) {
+        for (int c = 0; c < chunk_count; c++) {
+            for (int s = 0; s < ESTIMATION_SHARDS; s++) {
+                free_count_map(&chunks[c].shards[s]);
+            }
+        }
+        free(chunks);
+        return -1;
+    }
+
+    run_parallel(pool, ESTIMATION_SHARDS, merge_shard_task, &ctx);
+
+    for (int c = 0; c < chunk_count; c++) {
+        estimator->sequences += chunks[c].sequences;
+        estimator->transitions += chunks[c].transitions;
+        if (!estimator->fixed_length && chunks[c].max_state >= estimator->length) {
+            estimator->length = chunks[c].max_state + 1;
+        }
+    }
+    *line = lines;
+    free(chunks);
+    return 0;
+}
+
+// Fusion du fragment s d'un estimateur dans le fragment s d'un autre (sans verrou)
+typedef struct s_merge_context {
+    t_estimator *target;
+    const t_estimator *source;
+} t_merge_context;
+
+static void merge_estimator_task(void *context, int shard) {
+    t_merge_context *ctx = context;
+    t_count_map *target = &ctx->target->shards[shard];
+    const t_count_map *source = &ctx->source->shards[shard];
+    for (int k = 0; k < source->capacity; k++) {
+        if (source->keys[k] != ESTIMATION_EMPTY_KEY) add_count(target, source->keys[k], source->counts[k]);
+    }
+}
+
+int estimator_add_stream(t_estimator *estimator, FILE *stream, t_parse_error *error) {
+    // Les comptes du flux sont accumulés à part et ne rejoignent l'estimateur qu'une fois tout le flux valide
+    t_estimator staged = create_estimator(estimator->fixed_length ? estimator->length : 0);
+    size_t capacity = ESTIMATION_BLOCK_SIZE, filled = 0;
+    char *buffer = malloc(capacity);
+    if (buffer == NULL) exit(EXIT_FAILURE);
+    long line = 1;
+    int status = 0;
+
+    while (true) {
+        size_t read = fread(buffer + filled, 1, capacity - filled, stream);
+        filled += read;
+
+        // Erreur d'entrée-sortie : le flux tronqué n'est pas compté
+        if (ferror(stream)) {
+            error->line = line;
+            snprintf(error->message, sizeof(error->message), "erreur de lecture du flux");
+            status = -1;
+            break;
+        }
+        if (read == 0) {
+            // Fin du flux : dernière ligne éventuellement sans '\n'
+            if (filled > 0) status = estimator_add_buffer(&staged, buffer, buffer + filled, &line, error);
+            break;
+        }
+
+        size_t complete = filled;
+        while (complete > 0 && buffer[complete - 1] != '\n') complete--;
+
+        if (complete == 0) {
+            // Ligne plus longue que le tampon : on l'agrandit
+            if (filled == capacity) {
+                capacity *= 2;
+                buffer = realloc(buffer, capacity);
+                if (buffer == NULL) exit(EXIT_FAILURE);
+            }
+            continue;
+        }
+
+        status = estimator_add_buffer(&staged, buffer, buffer + complete, &line, error);
+        if (status != 0) break;
+        memmove(buffer, buffer + complete, filled - complete);
+        filled -= complete;
+    }
+    free(buffer);
+
+    if (status == 0) {
+        long long distinct = 0;
+        for (int s = 0; s < ESTIMATION_SHARDS; s++) {
+            distinct += staged.shards[s].count;
+        }
+        t_merge_context ctx = { .target = estimator, .source = &staged };
+        run_parallel(pool_for_work((long) distinct), ESTIMATION_SHARDS, merge_estimator_task, &ctx);
+
+        estimator->sequences += staged.sequences;
+        estimator->transitions += staged.transitions;
+        if (!estimator->fixed_length && staged.length > estimator->length) estimator->length = staged.length;
+    }
+    free_estimator(&staged);
+    return status;
+}
+
+// Contexte partagé de la normalisation : fragment s -> tableau d'arêtes parts[s]
+typedef struct s_estimate_task {
+    const t_estimator *estimator;
+    double *row_totals;
+    t_edge_list *parts;
+    int *unobserved;                // États sans transition observée, par fragment
+} t_estimate_task;
+
+static void row_totals_task(void *context, int shard) {
+    t_estimate_task *task = context;
+    const t_count_map *map = &task->estimator->shards[shard];
+    for (int k = 0; k < map->capacity; k++) {
+        if (map->keys[k] != ESTIMATION_EMPTY_KEY) {
+            task->row_totals[map->keys[k] >> 32] += map->counts[k];
+        }
+    }
+}
+
+static void normalize_task(void *context, int shard) {
+    t_estimate_task *task = context;
+    const t_count_map *map = &task->estimator->shards[shard];
+    t_edge_list *part = &task->parts[shard];
+    *part = create_edge_list(map->count + 1);
+
+    for (int k = 0; k < map->capacity; k++) {
+        if (map->keys[k] == ESTIMATION_EMPTY_KEY) continue;
+        int from = (int) (map->keys[k] >> 32);
+        int to = (int) (uint32_t) map->keys[k];
+        edge_list_add(part, from, to, (float) (map->counts[k] / task->row_totals[from]));
+    }
+
+    // États du fragment jamais quittés : boucle de probabilité 1
+    task->unobserved[shard] = 0;
+    for (int i = shard; i < task->estimator->length; i += ESTIMATION_SHARDS) {
+        if (task->row_totals[i] == 0.0) {
+            edge_list_add(part, i, i, 1.0f);
+            task->unobserved[shard]++;
+        }
+    }
+}
+
+// Contexte partagé du tri des lignes par colonne croissante
+typedef struct s_sort_task {
+    t_adj_list *graph;
+    const int *block_starts;
+} t_sort_task;
+
+typedef struct s_column_value {
+    int dest;
+    float proba;
+} t_column_value;
+
+static int compare_columns(const void *a, const void *b) {
+    int x = ((const t_column_value *) a)->dest, y = ((const t_column_value *) b)->dest;
+    return (x > y) - (x < y);
+}
+
+static void sort_rows_task(void *context, int block) {
+    t_sort_task *task = context;
+    t_adj_list *graph = task->graph;
+    t_column_value *row = NULL;
+    int capacity = 0;
+
+    for (int i = task->block_starts[block]; i < task->block_starts[block + 1]; i++) {
+        int first = graph->offsets[i], count = graph->offsets[i + 1] - first;
+        int *dest = graph->dest + first;
+        float *proba = graph->proba + first;
+
+        if (count <= 32) {
+            // Insertion pour les lignes courtes (cas courant)
+            for (int t = 1; t < count; t++) {
+                int column = dest[t], u = t - 1;
+                float value = proba[t];
+                while (u >= 0 && dest[u] > column) {
+                    dest[u + 1] = dest[u];
+                    proba[u + 1] = proba[u];
+                    u--;
+                }
+                dest[u + 1] = column;
+                proba[u + 1] = value;
+            }
+            continue;
+        }
+
+        if (count > capacity) {
+            capacity = count;
+            row = realloc(row, capacity * sizeof(t_column_value));
+            if (row == NULL) exit(EXIT_FAILURE);
+        }
+        for (int t = 0; t < count; t++) {
+            row[t].dest = dest[t];
+            row[t].proba = proba[t];
+        }
+        qsort(row, count, sizeof(t_column_value), compare_columns);
+        for (int t = 0; t < count; t++) {
+            dest[t] = row[t].dest;
+            proba[t] = row[t].proba;
+        }
+    }
+    free(row);
+}
+
+t_adj_list estimate_graph(t_estimator *estimator) {
+    int length = estimator->length;
+    long long distinct = 0;
+    for (int s = 0; s < ESTIMATION_SHARDS; s++) {
+        distinct += estimator->shards[s].count;
+    }
+
+    t_estimate_task task = { .estimator = estimator };
+    task.row_totals = calloc(length > 0 ? length : 1, sizeof(double));
+    task.parts = malloc(ESTIMATION_SHARDS * sizeof(t_edge_list));
+    task.unobserved = malloc(ESTIMATION_SHARDS * sizeof(int));
+    if (task.row_totals == NULL || task.parts == NULL || task.unobserved == NULL) exit(EXIT_FAILURE);
+
+    // Chaque fragment contient des lignes complètes : totaux et normalisation sans verrou
+    t_thread_pool *pool = pool_for_work((long) (distinct + length));
+    run_parallel(pool, ESTIMATION_SHARDS, row_totals_task, &task);
+    run_parallel(pool, ESTIMATION_SHARDS, normalize_task, &task);
+
+    t_adj_list graph = build_adjlist_parts(length, task.parts, ESTIMATION_SHARDS);
+
+    estimator->unobserved_states = 0;
+    for (int s = 0; s < ESTIMATION_SHARDS; s++) {
+        estimator->unobserved_states += task.unobserved[s];
+        free_edge_list(&task.parts[s]);
+    }
+
+    // L'ordre des tables de hachage dépend du découpage : colonnes croissantes pour un graphe reproductible
+    int block_count = pool != NULL ? pool->thread_count * 4 : 1;
+    int *block_starts = balanced_blocks(&graph, block_count);
+    t_sort_task sort_task = { .graph = &graph, .block_starts = block_starts };
+    run_parallel(pool, block_count, sort_rows_task, &sort_task);
+
+    free(block_starts);
+    free(task.row_totals);
+    free(task.parts);
+    free(task.unobserved);
+    return graph;
+}
+
+void display_estimator(const t_estimator *estimator) {
+    long long distinct = 0;
+    for (int s = 0; s < ESTIMATION_SHARDS; s++) {
+        distinct += estimator->shards[s].count;
+    }
+    printf("Estimation : %lld sequences, %lld transitions observees (%lld distinctes), %d etats.\n",
+           estimator->sequences, estimator->transitions, distinct, estimator->length);
+    if (estimator->unobserved_states > 0) {
+        printf("%d etats sans transition sortante observee : boucle de probabilite 1 ajoutee.\n", estimator->unobserved_states);
+    }
+}
+
+void free_estimator(t_estimator *estimator) {
+    for (int s = 0; s < ESTIMATION_SHARDS; s++) {
+        free_count_map(&estimator->shards[s]);
+    }
+}
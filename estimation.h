@@ -0,0 +1,92 @@
+#ifndef __ESTIMATION_H__
+#define __ESTIMATION_H__
+
+#include <stdint.h>
+#include "utils.h"
+#include "parser.h"
+
+#define ESTIMATION_SHARDS 64                // Nombre de fragments des tables de comptage (puissance de 2)
+#define ESTIMATION_BLOCK_SIZE (16 << 20)    // Taille des blocs lus dans un flux (octets)
+
+// Table de hachage (adressage ouvert, sondage linéaire) : transition (from, to) -> nombre d'observations
+typedef struct s_count_map {
+    int capacity;                   // Nombre de cases (puissance de 2)
+    int count;                      // Nombre de transitions distinctes
+    uint64_t *keys;                 // Clé (from << 32) | to de chaque case, ou case vide
+    long long *counts;              // Nombre d'observations de chaque case
+} t_count_map;
+
+// Comptes de transitions accumulés au fil des lots. Les transitions sont réparties entre les
+// fragments selon leur état de départ : un fragment contient des lignes complètes, et chaque
+// fragment se fusionne et se normalise indépendamment des autres.
+typedef struct s_estimator {
+    int length;                     // Nombre d'états (fixé, ou plus grand identifiant vu si inféré)
+    bool fixed_length;              // true si les identifiants au-delà de length sont refusés
+    t_count_map shards[ESTIMATION_SHARDS]; // Comptes, par fragment
+    long long sequences;            // Nombre de séquences lues
+    long long transitions;          // Nombre de transitions observées
+    int unobserved_states;          // États sans transition sortante au dernier estimate_graph
+} t_estimator;
+
+/**
+ * @brief Crée un estimateur vide.
+ * @param length Le nombre d'états, ou 0 pour le déduire du plus grand identifiant rencontré.
+ * @return L'estimateur (à libérer avec free_estimator).
+ */
+t_estimator create_estimator(int length);
+
+/**
+ * @brief Ajoute une séquence d'états observée (index à partir de 0) : une transition par paire consécutive.
+ * @param estimator Pointeur vers l'estimateur.
+ * @param states Les états de la séquence.
+ * @param count Nombre d'états.
+ */
+void estimator_add_sequence(t_estimator *estimator, const int *states, int count);
+
+/**
+ * @brief Ajoute un lot de séquences au format texte : une séquence par ligne, identifiants d'états
+ * (à partir de 1) séparés par des blancs ou des virgules, lignes vides ignorées. Le lot est découpé
+ * en morceaux comptés en parallèle dans des tables propres à chaque thread, puis fusionnées
+ * fragment par fragment. Un lot invalide n'est pas pris en compte.
+ * @param estimator Pointeur vers l'estimateur.
+ * @param data Début du tampon (début de ligne).
+ * @param end Fin du tampon.
+ * @param line Pointeur vers le compteur de lignes (mis à jour).
+ * @param error Pointeur vers l'erreur à remplir en cas d'échec.
+ * @return 0 en cas de succès, -1 en cas d'erreur.
+ */
+int estimator_add_buffer(t_estimator *estimator, const char *data, const char *end, long *line, t_parse_error *error);
+
+/**
+ * @brief Consomme un flux de séquences par blocs de ESTIMATION_BLOCK_SIZE octets coupés en fin de
+ * ligne, sans charger tout le flux en mémoire. Les comptes du flux sont accumulés dans des tables
+ * propres à l'appel et fusionnés dans l'estimateur seulement si tout le flux est valide.
+ * @param estimator Pointeur vers l'estimateur.
+ * @param stream Le flux (fichier ou entrée standard).
+ * @param error Pointeur vers l'erreur à remplir en cas d'échec, ligne invalide ou erreur de lecture (ligne à partir du début du flux).
+ * @return 0 en cas de succès, -1 en cas d'erreur (l'estimateur est alors inchangé).
+ */
+int estimator_add_stream(t_estimator *estimator, FILE *stream, t_parse_error *error);
+
+/**
+ * @brief Construit le graphe estimé : p(i, j) = n(i, j) / somme des n(i, k), colonnes croissantes.
+ * Un état sans transition sortante observée reçoit une boucle de probabilité 1.
+ * L'estimateur reste utilisable pour de nouveaux lots.
+ * @param estimator Pointeur vers l'estimateur.
+ * @return Le graphe (à libérer avec free_adjlist).
+ */
+t_adj_list estimate_graph(t_estimator *estimator);
+
+/**
+ * @brief Affiche le nombre de séquences, de transitions observées et distinctes, et d'états.
+ * @param estimator Pointeur vers l'estimateur.
+ */
+void display_estimator(const t_estimator *estimator);
+
+/**
+ * @brief Libère l'estimateur.
+ * @param estimator Pointeur vers l'estimateur.
+ */
+void free_estimator(t_estimator *estimator);
+
+#endif // __ESTIMATION_H__
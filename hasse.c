@@ -3,47 +3,43 @@
 #include <stdlib.h>
 #include <string.h>
 #include <limits.h>
+#include <stdint.h>
 
-t_stack create_stack() {
+t_stack create_stack(int initial_capacity) {
     t_stack new_stack;
-    new_stack.head = NULL;
+    if (initial_capacity < 1) initial_capacity = 1;
+
+    new_stack.values = malloc(initial_capacity * sizeof(int));
+    if (new_stack.values == NULL) exit(EXIT_FAILURE);
+    new_stack.size = 0;
+    new_stack.capacity = initial_capacity;
     return new_stack;
 }
 
 void push(t_stack *stack, int value) {
-    t_stack_cell *new_cell = malloc(sizeof(t_stack_cell));
-    if (new_cell == NULL) exit(EXIT_FAILURE);
+    if (stack->size >= stack->capacity) {
+        stack->capacity *= 2;
+        stack->values = realloc(stack->values, stack->capacity * sizeof(int));
+        if (stack->values == NULL) exit(EXIT_FAILURE);
+    }
 
-    new_cell->value = value;
-    new_cell->next = stack->head;
-    stack->head = new_cell;
+    stack->values[stack->size++] = value;
 }
 
 int pop(t_stack *stack) {
-    if (stack->head == NULL) return -1;
-
-    t_stack_cell *temp = stack->head;
-    int value = temp->value;
-    stack->head = stack->head->next;
-    free(temp);
-    return value;
+    if (stack->size == 0) return -1;
+    return stack->values[--stack->size];
 }
 
 bool is_empty(t_stack stack) {
-    return stack.head == NULL;
+    return stack.size == 0;
 }
 
 void free_stack(t_stack *stack) {
-    t_stack_cell *temp = stack->head;
-    t_stack_cell *next = NULL;
-
-    while (temp != NULL) {
-        next = temp->next;
-        free(temp);
-        temp = next;
-    }
-
-    stack->head = NULL;
+    free(stack->values);
+    stack->values = NULL;
+    stack->size = 0;
+    stack->capacity = 0;
 }
 
 t_tarjan_vertex *create_tarjan_array(t_adj_list *graph) {
@@ -78,7 +74,7 @@ int add_class(t_partition *partition, t_classe new_class) {
         if (partition->classes == NULL) exit(EXIT_FAILURE);
     }
     
-    sprintf(new_class.name, "C%d", partition->class_count + 1);
+    snprintf(new_class.name, sizeof(new_class.name), "C%d", partition->class_count + 1);
     
     partition->classes[partition->class_count] = new_class;
     return partition->class_count++;
@@ -124,61 +120,86 @@ void display_partition(t_partition partition) {
     }
 }
 
-void parcours(int curr_vertex_index, t_adj_list *graph, t_tarjan_vertex tarjan_array[], t_stack *stack, t_partition *partition, int *timer) {
+void parcours(int curr_vertex_index, t_adj_list *graph, t_tarjan_vertex tarjan_array[], t_stack *stack, t_tarjan_frame *frames, t_partition *partition, int *timer) {
+    int frame_count = 0;
+
     tarjan_array[curr_vertex_index].index = tarjan_array[curr_vertex_index].lowlink = ++(*timer);
     push(stack, curr_vertex_index);
     tarjan_array[curr_vertex_index].on_stack = true;
-
-    t_list temporary_list = graph->list[curr_vertex_index]; 
-    t_cell *temp_edge = temporary_list.head;
-    
-    while (temp_edge != NULL) {
-        int dest_vertex_index = temp_edge->dest;
-        
-        if (tarjan_array[dest_vertex_index].index == -1) {
-            parcours(dest_vertex_index, graph, tarjan_array, stack, partition, timer); 
-            tarjan_array[curr_vertex_index].lowlink = (tarjan_array[curr_vertex_index].lowlink < tarjan_array[dest_vertex_index].lowlink) ? tarjan_array[curr_vertex_index].lowlink : tarjan_array[dest_vertex_index].lowlink;
+    frames[frame_count].vertex = curr_vertex_index;
+    frames[frame_count].next_edge = graph->offsets[curr_vertex_index];
+    frame_count++;
+
+    while (frame_count > 0) {
+        t_tarjan_frame *frame = &frames[frame_count - 1];
+        int vertex = frame->vertex;
+
+        if (frame->next_edge < graph->offsets[vertex + 1]) {
+            int dest_vertex_index = graph->dest[frame->next_edge++];
+
+            if (tarjan_array[dest_vertex_index].index == -1) {
+                // Équivalent de l'appel récursif : on empile un nouveau cadre
+                tarjan_array[dest_vertex_index].index = tarjan_array[dest_vertex_index].lowlink = ++(*timer);
+                push(stack, dest_vertex_index);
+                tarjan_array[dest_vertex_index].on_stack = true;
+                frames[frame_count].vertex = dest_vertex_index;
+                frames[frame_count].next_edge = graph->offsets[dest_vertex_index];
+                frame_count++;
+            }
+            else if (tarjan_array[dest_vertex_index].on_stack) {
+                tarjan_array[vertex].lowlink = (tarjan_array[vertex].lowlink < tarjan_array[dest_vertex_index].index) ? tarjan_array[vertex].lowlink : tarjan_array[dest_vertex_index].index;
+            }
+            continue;
         }
-        else if (tarjan_array[dest_vertex_index].on_stack) {
-            tarjan_array[curr_vertex_index].lowlink = (tarjan_array[curr_vertex_index].lowlink < tarjan_array[dest_vertex_index].index) ? tarjan_array[curr_vertex_index].lowlink : tarjan_array[dest_vertex_index].index;
+
+        // Toutes les arêtes de vertex sont traitées : retour au cadre parent
+        frame_count--;
+        if (frame_count > 0) {
+            int parent = frames[frame_count - 1].vertex;
+            tarjan_array[parent].lowlink = (tarjan_array[parent].lowlink < tarjan_array[vertex].lowlink) ? tarjan_array[parent].lowlink : tarjan_array[vertex].lowlink;
         }
-        temp_edge = temp_edge->next;
-    }
 
-    if (tarjan_array[curr_vertex_index].lowlink == tarjan_array[curr_vertex_index].index) {
-        
-        t_classe new_class;
-        new_class.vertex_ids = NULL;
-        new_class.vertex_count = 0;
-        new_class.capacity = 0; 
-        
-        int popped_vertex_index;
-        do {
-            popped_vertex_index = pop(stack);
-            tarjan_array[popped_vertex_index].on_stack = false;
-            add_vertex_to_class(&new_class, tarjan_array[popped_vertex_index].id); 
-        } while (curr_vertex_index != popped_vertex_index);
-        
-        add_class(partition, new_class);
+        if (tarjan_array[vertex].lowlink == tarjan_array[vertex].index) {
+            // La classe est le haut de la pile jusqu'à vertex : une seule allocation à la bonne taille
+            int first = stack->size - 1;
+            while (stack->values[first] != vertex) first--;
+
+            t_classe new_class;
+            new_class.vertex_count = 0;
+            new_class.capacity = stack->size - first;
+            new_class.vertex_ids = malloc(new_class.capacity * sizeof(int));
+            if (new_class.vertex_ids == NULL) exit(EXIT_FAILURE);
+
+            int popped_vertex_index;
+            do {
+                popped_vertex_index = pop(stack);
+                tarjan_array[popped_vertex_index].on_stack = false;
+                new_class.vertex_ids[new_class.vertex_count++] = tarjan_array[popped_vertex_index].id;
+            } while (vertex != popped_vertex_index);
+
+            add_class(partition, new_class);
+        }
     }
 }
 
 t_partition tarjan(t_adj_list *graph) {
     
     t_tarjan_vertex *tarjan_array = create_tarjan_array(graph); 
-    t_stack stack = create_stack();       
+    t_stack stack = create_stack(graph->length);
+    t_tarjan_frame *frames = malloc((graph->length > 0 ? graph->length : 1) * sizeof(t_tarjan_frame));
     t_partition partition = create_partition(graph->length / 2 + 1); 
+    if (tarjan_array == NULL || frames == NULL) exit(EXIT_FAILURE);
 
     int timer_count = 0; 
-    int class_id_counter = 0; 
 
     for (int curr_vertex_index = 0; curr_vertex_index < graph->length; curr_vertex_index++) {
         if (tarjan_array[curr_vertex_index].index == -1) {
-            parcours(curr_vertex_index, graph, tarjan_array, &stack, &partition, &timer_count);
+            parcours(curr_vertex_index, graph, tarjan_array, &stack, frames, &partition, &timer_count);
         }
     }
 
     free_stack(&stack);
+    free(frames);
     free(tarjan_array);
     return partition;
 }
@@ -192,15 +213,7 @@ t_link_array create_link_array(int initial_capacity) {
     return link_array;
 }
 
-void add_link(t_link_array *link_array, int from, int dest) {
-    if (from == dest) return; 
-
-    for (int i = 0; i < link_array->link_count; i++) {
-        if (link_array->links[i].class_from == from && link_array->links[i].class_dest == dest) {
-            return;
-        }
-    }
-
+static void append_link(t_link_array *link_array, int from, int dest) {
     if (link_array->link_count >= link_array->capacity) {
         link_array->capacity *= 2;
         link_array->links = realloc(link_array->links, link_array->capacity * sizeof(t_link));
@@ -212,6 +225,17 @@ void add_link(t_link_array *link_array, int from, int dest) {
     link_array->link_count++;
 }
 
+void add_link(t_link_array *link_array, int from, int dest) {
+    if (from == dest) return; 
+
+    for (int i = 0; i < link_array->link_count; i++) {
+        if (link_array->links[i].class_from == from && link_array->links[i].class_dest == dest) {
+            return;
+        }
+    }
+
+    append_link(link_array, from, dest);
+}
 
 int *create_class_map(t_partition *partition, int graph_length) {
     int *class_map = malloc(graph_length * sizeof(int));
@@ -236,60 +260,241 @@ int *create_class_map(t_partition *partition, int graph_length) {
 }
 
 t_link_array find_class_links(t_adj_list *graph, t_partition *partition, int *class_map) {
-    t_link_array link_array = create_link_array(graph->length);
-    
-    for (int i = 0; i < graph->length; i++) {
-        int from_class_index = class_map[i]; 
-        
-        t_cell *temp_edge = graph->list[i].head;
-
-        while (temp_edge != NULL) {
-            int dest_vertex_index = temp_edge->dest;
-            int dest_class_index = class_map[dest_vertex_index]; 
-            
-            if (from_class_index != dest_class_index && from_class_index != -1 && dest_class_index != -1) {
-                add_link(&link_array, from_class_index, dest_class_index);
+    t_link_array link_array = create_link_array(graph->length > 0 ? graph->length : 1);
+
+    // last_source[d] = dernière classe source pour laquelle le lien vers d a été ajouté :
+    // en parcourant les sommets classe par classe, chaque lien n'est ajouté qu'une fois, sans recherche
+    int *last_source = malloc((partition->class_count > 0 ? partition->class_count : 1) * sizeof(int));
+    if (last_source == NULL) exit(EXIT_FAILURE);
+    for (int i = 0; i < partition->class_count; i++) {
+        last_source[i] = -1;
+    }
+
+    for (int from_class_index = 0; from_class_index < partition->class_count; from_class_index++) {
+        t_classe *class = &partition->classes[from_class_index];
+
+        for (int i = 0; i < class->vertex_count; i++) {
+            int vertex_index = class->vertex_ids[i] - 1;
+
+            for (int edge = graph->offsets[vertex_index]; edge < graph->offsets[vertex_index + 1]; edge++) {
+                int dest_class_index = class_map[graph->dest[edge]];
+
+                if (from_class_index != dest_class_index && dest_class_index != -1 && last_source[dest_class_index] != from_class_index) {
+                    last_source[dest_class_index] = from_class_index;
+                    append_link(&link_array, from_class_index, dest_class_index);
+                }
             }
-            temp_edge = temp_edge->next;
         }
     }
+
+    free(last_source);
     return link_array;
 }
 
-void remove_transitive_links(t_link_array *link_array) {
-    int i = 0;
-
-    while (i < link_array->link_count) {
-        t_link link1 = link_array->links[i];
-        bool to_remove = false;
-        for (int j = 0; j < link_array->link_count && !to_remove; j++) {
-            if (j != i) {
-                t_link link2 = link_array->links[j];
-                if (link1.class_from == link2.class_from) {
-                    for (int k = 0; k < link_array->link_count && !to_remove; k++) {
-                        if (k != j && k != i) {
-                            t_link link3 = link_array->links[k];
-                            if ((link3.class_from == link2.class_dest) && (link3.class_dest == link1.class_dest)) {
-                                to_remove = true;
-                            }
-                        }
-                    }
+void free_link_array(t_link_array *link_array) {
+    free(link_array->links);
+    link_array->links = NULL;
+    link_array->link_count = 0;
+    link_array->capacity = 0;
+}
+
+// Liens rangés par classe source (format CSR), destinations triées par position topologique
+typedef struct s_class_dag {
+    int class_count;                // Nombre de classes
+    int *offsets;                   // Les liens de la classe c sont dans [offsets[c], offsets[c+1])
+    int *dest;                      // Classes destination
+    int *link_index;                // Index du lien correspondant dans le t_link_array
+} t_class_dag;
+
+int *topological_sort_classes(t_link_array *link_array, int class_count) {
+    int *in_degree = calloc(class_count > 0 ? class_count : 1, sizeof(int));
+    int *offsets = calloc(class_count + 1, sizeof(int));
+    int *children = malloc((link_array->link_count > 0 ? link_array->link_count : 1) * sizeof(int));
+    int *order = malloc((class_count > 0 ? class_count : 1) * sizeof(int));
+    if (in_degree == NULL || offsets == NULL || children == NULL || order == NULL) exit(EXIT_FAILURE);
+
+    for (int i = 0; i < link_array->link_count; i++) {
+        offsets[link_array->links[i].class_from + 1]++;
+        in_degree[link_array->links[i].class_dest]++;
+    }
+    for (int c = 0; c < class_count; c++) {
+        offsets[c + 1] += offsets[c];
+    }
+    int *cursor = malloc((class_count > 0 ? class_count : 1) * sizeof(int));
+    if (cursor == NULL) exit(EXIT_FAILURE);
+    memcpy(cursor, offsets, class_count * sizeof(int));
+    for (int i = 0; i < link_array->link_count; i++) {
+        children[cursor[link_array->links[i].class_from]++] = link_array->links[i].class_dest;
+    }
+
+    // Algorithme de Kahn : order sert aussi de file
+    int head = 0, tail = 0;
+    for (int c = 0; c < class_count; c++) {
+        if (in_degree[c] == 0) order[tail++] = c;
+    }
+    while (head < tail) {
+        int c = order[head++];
+        for (int i = offsets[c]; i < offsets[c + 1]; i++) {
+            if (--in_degree[children[i]] == 0) order[tail++] = children[i];
+        }
+    }
+
+    free(cursor);
+    free(children);
+    free(offsets);
+    free(in_degree);
+
+    if (tail < class_count) {
+        free(order);
+        return NULL;
+    }
+    return order;
+}
+
+// Construit le DAG des classes, chaque liste de destinations étant triée par position topologique
+static t_class_dag create_class_dag(t_link_array *link_array, int class_count, int *position) {
+    t_class_dag dag;
+    int link_count = link_array->link_count;
+    dag.class_count = class_count;
+    dag.offsets = calloc(class_count + 1, sizeof(int));
+    dag.dest = malloc((link_count > 0 ? link_count : 1) * sizeof(int));
+    dag.link_index = malloc((link_count > 0 ? link_count : 1) * sizeof(int));
+    int *by_position = malloc((link_count > 0 ? link_count : 1) * sizeof(int));
+    int *bucket = calloc(class_count + 1, sizeof(int));
+    if (dag.offsets == NULL || dag.dest == NULL || dag.link_index == NULL || by_position == NULL || bucket == NULL) exit(EXIT_FAILURE);
+
+    // Tri par comptage des liens selon la position de leur destination...
+    for (int i = 0; i < link_count; i++) {
+        bucket[position[link_array->links[i].class_dest] + 1]++;
+    }
+    for (int c = 0; c < class_count; c++) {
+        bucket[c + 1] += bucket[c];
+    }
+    for (int i = 0; i < link_count; i++) {
+        by_position[bucket[position[link_array->links[i].class_dest]]++] = i;
+    }
+
+    // ... puis tri stable par classe source
+    for (int i = 0; i < link_count; i++) {
+        dag.offsets[link_array->links[i].class_from + 1]++;
+    }
+    for (int c = 0; c < class_count; c++) {
+        dag.offsets[c + 1] += dag.offsets[c];
+    }
+    memcpy(bucket, dag.offsets, class_count * sizeof(int));
+    for (int k = 0; k < link_count; k++) {
+        int i = by_position[k];
+        int pos = bucket[link_array->links[i].class_from]++;
+        dag.dest[pos] = link_array->links[i].class_dest;
+        dag.link_index[pos] = i;
+    }
+
+    free(bucket);
+    free(by_position);
+    return dag;
+}
+
+static void free_class_dag(t_class_dag *dag) {
+    free(dag->offsets);
+    free(dag->dest);
+    free(dag->link_index);
+}
+
+void transitive_reduction(t_link_array *link_array, int class_count) {
+    int *order = topological_sort_classes(link_array, class_count);
+    if (order == NULL) return;
+
+    int *position = malloc((class_count > 0 ? class_count : 1) * sizeof(int));
+    int *remaining_parents = calloc(class_count > 0 ? class_count : 1, sizeof(int));
+    bool *keep = calloc(link_array->link_count > 0 ? link_array->link_count : 1, sizeof(bool));
+    uint64_t **reach = calloc(class_count > 0 ? class_count : 1, sizeof(uint64_t *));
+    if (position == NULL || remaining_parents == NULL || keep == NULL || reach == NULL) exit(EXIT_FAILURE);
+
+    for (int p = 0; p < class_count; p++) {
+        position[order[p]] = p;
+    }
+    for (int i = 0; i < link_array->link_count; i++) {
+        remaining_parents[link_array->links[i].class_dest]++;
+    }
+
+    t_class_dag dag = create_class_dag(link_array, class_count, position);
+    int word_count = (class_count + 63) / 64;
+
+    // reach[c] : ensemble (indexé par position topologique) des classes atteignables depuis c.
+    // Seules les positions > position[c] sont possibles : les mots précédents ne sont pas alloués,
+    // et le mot w est rangé dans reach[c][w - first_word], first_word = (position[c] + 1) / 64.
+    for (int p = class_count - 1; p >= 0; p--) {
+        int c = order[p];
+        if (dag.offsets[c] == dag.offsets[c + 1]) continue;
+
+        int first_word = (p + 1) / 64;
+        reach[c] = calloc(word_count - first_word, sizeof(uint64_t));
+        if (reach[c] == NULL) exit(EXIT_FAILURE);
+
+        // Les enfants sont examinés par position croissante : un enfant déjà atteint
+        // via un enfant précédent correspond à un lien transitif
+        for (int i = dag.offsets[c]; i < dag.offsets[c + 1]; i++) {
+            int child = dag.dest[i];
+            int child_position = position[child];
+
+            uint64_t *child_word = &reach[c][child_position / 64 - first_word];
+            if ((*child_word >> (child_position % 64)) & 1) continue;
+
+            keep[dag.link_index[i]] = true;
+            *child_word |= (uint64_t) 1 << (child_position % 64);
+
+            if (reach[child] != NULL) {
+                int child_first_word = (child_position + 1) / 64;
+                uint64_t *restrict target = reach[c] + (child_first_word - first_word);
+                const uint64_t *restrict source = reach[child];
+                for (int w = 0; w < word_count - child_first_word; w++) {
+                    target[w] |= source[w];
                 }
             }
         }
-        if (to_remove) {
-            link_array->links[i] = link_array->links[link_array->link_count - 1];
-            link_array->link_count--;
+
+        // Les ensembles des enfants dont tous les parents sont traités sont libérés
+        for (int i = dag.offsets[c]; i < dag.offsets[c + 1]; i++) {
+            int child = dag.dest[i];
+            if (--remaining_parents[child] == 0 && reach[child] != NULL) {
+                free(reach[child]);
+                reach[child] = NULL;
+            }
         }
-        else {
-            i++;
+        if (remaining_parents[c] == 0) {
+            free(reach[c]);
+            reach[c] = NULL;
         }
     }
+
+    int kept = 0;
+    for (int i = 0; i < link_array->link_count; i++) {
+        if (keep[i]) link_array->links[kept++] = link_array->links[i];
+    }
+    link_array->link_count = kept;
+
+    free_class_dag(&dag);
+    free(reach);
+    free(keep);
+    free(remaining_parents);
+    free(position);
+    free(order);
 }
 
-void analyze_markov_properties(t_partition *partition, t_link_array *link_array) {
-    bool *is_transient_map = calloc(partition->class_count, sizeof(bool));
-    if (is_transient_map == NULL) return; 
+void remove_transitive_links(t_link_array *link_array) {
+    int class_count = 0;
+
+    for (int i = 0; i < link_array->link_count; i++) {
+        if (link_array->links[i].class_from + 1 > class_count) class_count = link_array->links[i].class_from + 1;
+        if (link_array->links[i].class_dest + 1 > class_count) class_count = link_array->links[i].class_dest + 1;
+    }
+
+    transitive_reduction(link_array, class_count);
+}
+
+bool *find_transient_classes(t_partition *partition, t_link_array *link_array) {
+    bool *is_transient_map = calloc(partition->class_count > 0 ? partition->class_count : 1, sizeof(bool));
+    if (is_transient_map == NULL) exit(EXIT_FAILURE);
 
     for (int i = 0; i < link_array->link_count; i++) {
         int class_from = link_array->links[i].class_from;
@@ -298,6 +503,11 @@ void analyze_markov_properties(t_partition *partition, t_link_array *link_array)
             is_transient_map[class_from] = true;
         }
     }
+    return is_transient_map;
+}
+
+void analyze_markov_properties(t_partition *partition, t_link_array *link_array) {
+    bool *is_transient_map = find_transient_classes(partition, link_array);
   
     bool is_irreducible = (partition->class_count == 1);
     
@@ -12,20 +12,22 @@ typedef struct s_tarjan_vertex {
     bool on_stack;                  // Indique si le sommet est actuellement sur la pile
 } t_tarjan_vertex;
 
-// Maillon de la pile (implémentation par liste chaînée)
-typedef struct s_stack_cell {  
-    int value;                      // Stocke l'id du sommet
-    struct s_stack_cell *next;      // Pointeur vers le maillon suivant
-} t_stack_cell;
-
-// Structure de la pile
+// Structure de la pile (tableau dynamique, pas d'allocation par empilement)
 typedef struct s_stack {
-    t_stack_cell *head;             // Sommet de la pile
+    int *values;                    // Valeurs empilées (ids de sommets)
+    int size;                       // Nombre de valeurs dans la pile
+    int capacity;                   // Capacité actuelle du tableau
 } t_stack;
 
+// Cadre du parcours en profondeur itératif de Tarjan (remplace un appel récursif)
+typedef struct s_tarjan_frame {
+    int vertex;                     // Sommet en cours d'exploration
+    int next_edge;                  // Prochaine arête à examiner (index dans le graphe CSR)
+} t_tarjan_frame;
+
 // Structure représentant une Classe (Composante Fortement Connexe)
 typedef struct s_class {
-    char name[10];                  // Nom de la classe (ex: "C1", "C2", ...)       
+    char name[16];                  // Nom de la classe (ex: "C1", "C2", ... : "C" et tout int tiennent)       
     int vertex_count;               // Nombre de sommets dans la classe
     int capacity;                   // Capacité actuelle du tableau dynamique
     int *vertex_ids;                // Tableau dynamique des ids des sommets dans la classe      
@@ -61,9 +63,10 @@ t_tarjan_vertex *create_tarjan_array(t_adj_list *graph);
 
 /**
  * @brief Initialise une pile vide.
+ * @param initial_capacity Capacité initiale du tableau.
  * @return Une structure t_stack vide.
  */
-t_stack create_stack(); 
+t_stack create_stack(int initial_capacity); 
 
 /**
  * @brief Empile un entier (ID de sommet).
@@ -93,15 +96,18 @@ bool is_empty(t_stack stack);
 void free_stack(t_stack *stack);
 
 /**
- * @brief Fonction récursive principale (DFS) de l'algorithme de Tarjan.
- * @param u Index du sommet courant.
+ * @brief Parcours en profondeur (itératif) de l'algorithme de Tarjan depuis un sommet racine.
+ * La récursion est remplacée par une pile de cadres explicite : la pile native reste constante
+ * quelle que soit la profondeur du graphe.
+ * @param u Index du sommet racine.
  * @param adj_list Pointeur vers le graphe.
  * @param T Tableau des états Tarjan.
- * @param S Pointeur vers la pile.
+ * @param S Pointeur vers la pile des sommets.
+ * @param frames Pile de cadres, d'au moins graph->length éléments.
  * @param P Pointeur vers la partition en cours de construction.
  * @param timer Pointeur vers le compteur global de découverte.
  */
-void parcours(int curr_vertex_index, t_adj_list *graph, t_tarjan_vertex *tarjan_array, t_stack *stack, t_partition *partition, int *timer);
+void parcours(int curr_vertex_index, t_adj_list *graph, t_tarjan_vertex *tarjan_array, t_stack *stack, t_tarjan_frame *frames, t_partition *partition, int *timer);
 
 /**
  * @brief Exécute l'algorithme de Tarjan pour trouver les CFC du graphe.
@@ -160,7 +166,7 @@ t_link_array create_link_array(int initial_capacity);
 int *create_class_map(t_partition *partition, int graph_length);
 
 /**
- * @brief Ajoute un lien entre deux classes s'il n'existe pas déjà.
+ * @brief Ajoute un lien entre deux classes s'il n'existe pas déjà (recherche linéaire, O(L)).
  * @param link_array Pointeur vers le tableau de liens.
  * @param from Index de la classe source.
  * @param dest Index de la classe destination.
@@ -168,7 +174,9 @@ int *create_class_map(t_partition *partition, int graph_length);
 void add_link(t_link_array *link_array, int from, int dest); 
 
 /**
- * @brief Identifie tous les liens entre les classes du graphe.
+ * @brief Identifie tous les liens entre les classes du graphe, sans doublon, en O(V + E).
+ * Les sommets sont parcourus classe par classe ; un tableau "dernière classe source"
+ * par classe destination remplace la recherche dans les liens existants.
  * @param adj_list Pointeur vers le graphe original.
  * @param partition Pointeur vers la partition.
  * @param class_map Tableau de mappage sommet->classe.
@@ -176,8 +184,33 @@ void add_link(t_link_array *link_array, int from, int dest);
  */
 t_link_array find_class_links(t_adj_list *adj_list, t_partition *partition, int *class_map);
 
+/**
+ * @brief Libère la mémoire d'un tableau de liens.
+ * @param link_array Pointeur vers le tableau de liens.
+ */
+void free_link_array(t_link_array *link_array);
+
+/**
+ * @brief Trie les classes dans un ordre topologique (algorithme de Kahn).
+ * @param link_array Pointeur vers les liens entre classes.
+ * @param class_count Nombre de classes.
+ * @return Un tableau de class_count classes (sources en premier), ou NULL si les liens forment un cycle.
+ */
+int *topological_sort_classes(t_link_array *link_array, int class_count);
+
+/**
+ * @brief Réduction transitive exacte du DAG des classes (diagramme de Hasse).
+ * Les classes sont parcourues dans l'ordre topologique inverse avec des ensembles
+ * d'atteignabilité en bits (mots de 64 bits), soit environ O(C * L / 64).
+ * L'ordre relatif des liens conservés est inchangé ; rien n'est fait si les liens forment un cycle.
+ * @param link_array Pointeur vers le tableau de liens.
+ * @param class_count Nombre de classes.
+ */
+void transitive_reduction(t_link_array *link_array, int class_count);
+
 /**
  * @brief Supprime les liens transitifs (redondants) dans le tableau de liens.
+ * Le nombre de classes est déduit des liens, puis transitive_reduction() est appliquée.
  * @param p_link_array Pointeur vers le tableau de liens.
  */
 void remove_transitive_links(t_link_array *link_array); 
@@ -190,6 +223,15 @@ void remove_transitive_links(t_link_array *link_array);
  */
 void write_hasse_mermaid(t_partition *partition, t_link_array *link_array, FILE *file);
 
+/**
+ * @brief Repère les classes transitoires : celles qui ont un lien vers une autre classe.
+ * Les autres classes sont persistantes (fermées).
+ * @param partition Pointeur vers la partition.
+ * @param link_array Pointeur vers les liens inter-classes.
+ * @return Un tableau de booléens (un par classe, à libérer), true si la classe est transitoire.
+ */
+bool *find_transient_classes(t_partition *partition, t_link_array *link_array);
+
 /**
  * @brief Analyse et affiche les propriétés (Transitoire, Persistant, Absorbant, Irréductible).
  * @param partition Pointeur vers la partition.
@@ -1,13 +1,175 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <limits.h>
 #include "utils.h"
 #include "hasse.h"
+#include "threads.h"
+#include "binary.h"
+#include "scc.h"
+#include "matrix.h"
+#include "stationary.h"
+#include "absorption.h"
+#include "passage.h"
+#include "planner.h"
+#include "sparse.h"
+#include "propagation.h"
+#include "random_walk.h"
+#include "estimation.h"
 
-int main() {
+int main(int argc, char *argv[]) {
+
+    // Conversion texte -> binaire : TI_301_PJT --convert graphe.txt graphe.bin
+    if (argc >= 4 && strcmp(argv[1], "--convert") == 0) {
+        if (convert_text_to_binary(argv[2], argv[3]) != 0) {
+            perror("Conversion impossible");
+            return EXIT_FAILURE;
+        }
+        printf("Fichier binaire '%s' genere.\n", argv[3]);
+        return 0;
+    }
+
+    // Options : [fichier [--verify] | --trajectories=FICHIER...] [--scc=tarjan|parallel] [--threads=N] [--memory-budget=TAILLE] [--stationary[=power|arnoldi|gth]] [--power=P [--drop-tolerance=X]] [--limit] [--absorption] [--passage[=N]] [--from=I[,J...] --steps=N[,N...]]
+    //           [--walk[=N] [--walk-steps=S] [--walk-target=J] [--seed=X]]
+    const char *graph_filename = "data/exemple1.txt";
+    t_scc_engine scc_engine = SCC_TARJAN;
+    bool verify_graph = false;
+    bool compute_stationary = false;
+    t_stationary_method stationary_method = STATIONARY_POWER;
+    bool stationary_method_given = false;
+    int power = 0;
+    float drop_tolerance = SPARSE_DROP_TOLERANCE;
+    bool compute_limit = false;
+    bool compute_absorption_times = false;
+    bool compute_passage_times = false;
+    int passage_target = 1;
+    const char *start_list = "1";
+    const char *step_list = NULL;
+    long long walk_count = 0;
+    int walk_steps = RANDOM_WALK_DEFAULT_STEPS;
+    int walk_target = 0;
+    unsigned long long seed = RANDOM_WALK_DEFAULT_SEED;
+    const char **trajectory_files = malloc(argc * sizeof(char *));
+    int trajectory_count = 0;
+    if (trajectory_files == NULL) exit(EXIT_FAILURE);
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--verify") == 0) {
+            verify_graph = true;
+        } else if (strncmp(argv[i], "--scc=", 6) == 0) {
+            if (!parse_scc_engine(argv[i] + 6, &scc_engine)) {
+                fprintf(stderr, "Moteur de CFC inconnu : %s (tarjan ou parallel)\n", argv[i] + 6);
+                return EXIT_FAILURE;
+            }
+        } else if (strncmp(argv[i], "--threads=", 10) == 0) {
+            int thread_count = atoi(argv[i] + 10);
+            if (thread_count < 1) {
+                fprintf(stderr, "Nombre de threads invalide : %s\n", argv[i] + 10);
+                return EXIT_FAILURE;
+            }
+            set_thread_count(thread_count);
+        } else if (strncmp(argv[i], "--memory-budget=", 16) == 0) {
+            long long budget;
+            if (!parse_memory_size(argv[i] + 16, &budget)) {
+                fprintf(stderr, "Budget memoire invalide : %s (ex. 512M, 2G)\n", argv[i] + 16);
+                return EXIT_FAILURE;
+            }
+            set_memory_budget(budget);
+        } else if (strcmp(argv[i], "--stationary") == 0) {
+            compute_stationary = true;
+        } else if (strncmp(argv[i], "--stationary=", 13) == 0) {
+            if (!parse_stationary_method(argv[i] + 13, &stationary_method)) {
+                fprintf(stderr, "Methode stationnaire inconnue : %s (power, arnoldi ou gth)\n", argv[i] + 13);
+                return EXIT_FAILURE;
+            }
+            stationary_method_given = true;
+            compute_stationary = true;
+        } else if (strncmp(argv[i], "--power=", 8) == 0) {
+            power = atoi(argv[i] + 8);
+            if (power < 1) {
+                fprintf(stderr, "Puissance invalide : %s\n", argv[i] + 8);
+                return EXIT_FAILURE;
+            }
+        } else if (strncmp(argv[i], "--drop-tolerance=", 17) == 0) {
+            drop_tolerance = (float) atof(argv[i] + 17);
+            if (drop_tolerance < 0.0f) {
+                fprintf(stderr, "Seuil d'elimination invalide : %s\n", argv[i] + 17);
+                return EXIT_FAILURE;
+            }
+        } else if (strcmp(argv[i], "--limit") == 0) {
+            compute_limit = true;
+        } else if (strcmp(argv[i], "--absorption") == 0) {
+            compute_absorption_times = true;
+        } else if (strcmp(argv[i], "--passage") == 0) {
+            compute_passage_times = true;
+        } else if (strncmp(argv[i], "--passage=", 10) == 0) {
+            passage_target = atoi(argv[i] + 10);
+            if (passage_target < 1) {
+                fprintf(stderr, "Etat cible invalide : %s\n", argv[i] + 10);
+                return EXIT_FAILURE;
+            }
+            compute_passage_times = true;
+        } else if (strncmp(argv[i], "--from=", 7) == 0) {
+            start_list = argv[i] + 7;
+        } else if (strncmp(argv[i], "--steps=", 8) == 0) {
+            step_list = argv[i] + 8;
+        } else if (strcmp(argv[i], "--walk") == 0) {
+            walk_count = RANDOM_WALK_DEFAULT_WALKS;
+        } else if (strncmp(argv[i], "--walk=", 7) == 0) {
+            walk_count = atoll(argv[i] + 7);
+            if (walk_count < 1) {
+                fprintf(stderr, "Nombre de marches invalide : %s\n", argv[i] + 7);
+                return EXIT_FAILURE;
+            }
+        } else if (strncmp(argv[i], "--walk-steps=", 13) == 0) {
+            walk_steps = atoi(argv[i] + 13);
+            if (walk_steps < 1) {
+                fprintf(stderr, "Nombre de pas invalide : %s\n", argv[i] + 13);
+                return EXIT_FAILURE;
+            }
+        } else if (strncmp(argv[i], "--walk-target=", 14) == 0) {
+            walk_target = atoi(argv[i] + 14);
+            if (walk_target < 1) {
+                fprintf(stderr, "Etat cible invalide : %s\n", argv[i] + 14);
+                return EXIT_FAILURE;
+            }
+        } else if (strncmp(argv[i], "--seed=", 7) == 0) {
+            seed = strtoull(argv[i] + 7, NULL, 10);
+        } else if (strncmp(argv[i], "--trajectories=", 15) == 0) {
+            trajectory_files[trajectory_count++] = argv[i] + 15;
+        } else {
+            graph_filename = argv[i];
+        }
+    }
 
     // PARTIE 1 : CHARGEMENT ET VERIFICATION
 
-    t_adj_list graph = read_graph("data/exemple1.txt"); 
+    t_adj_list graph;
+    if (trajectory_count > 0) {
+        // Chaque fichier est un lot ajouté aux comptes des précédents ("-" : entrée standard)
+        t_estimator estimator = create_estimator(0);
+        for (int f = 0; f < trajectory_count; f++) {
+            FILE *stream = strcmp(trajectory_files[f], "-") == 0 ? stdin : fopen(trajectory_files[f], "rb");
+            if (stream == NULL) {
+                perror("Le fichier n'a pas pu etre ouvert");
+                exit(EXIT_FAILURE);
+            }
+            t_parse_error error;
+            if (estimator_add_stream(&estimator, stream, &error) != 0) {
+                fprintf(stderr, "%s, ligne %ld : %s\n", trajectory_files[f], error.line, error.message);
+                exit(EXIT_FAILURE);
+            }
+            if (stream != stdin) fclose(stream);
+            printf("Lot '%s' : ", trajectory_files[f]);
+            display_estimator(&estimator);
+        }
+        graph = estimate_graph(&estimator);
+        display_estimator(&estimator);
+        free_estimator(&estimator);
+    } else {
+        graph = load_graph(graph_filename, verify_graph);
+    }
+    free(trajectory_files);
     
     printf("--- Contenu du Graphe ---\n");
     print_adjlist(graph);
@@ -23,8 +185,8 @@ int main() {
 
     // PARTIE 2 : TARJAN & HASSE
 
-    printf("\n Algorithme de Tarjan...\n");
-    t_partition partition = tarjan(&graph); 
+    printf("\n Algorithme de %s...\n", scc_engine == SCC_PARALLEL ? "CFC parallele" : "Tarjan");
+    t_partition partition = find_scc(&graph, scc_engine); 
     display_partition(partition);
 
     printf("\n Diagramme de Hasse & Analyse...\n");
@@ -38,12 +200,209 @@ int main() {
     printf("\n Analyse des proprietes de Markov du diagramme de Hasse\n");
     analyze_markov_properties(&partition, &links);
 
+    printf("\n Periodes des classes persistantes\n");
+    t_plan period_plan = plan_analysis(&graph, ANALYSIS_PERIOD);
+    display_plan(&period_plan);
+    bool *is_transient = find_transient_classes(&partition, &links);
+    int *periods;
+    if (period_plan.engine == ENGINE_DENSE) {
+        t_matrix matrix = create_matrix_from_graph(&graph);
+        periods = calloc(partition.class_count > 0 ? partition.class_count : 1, sizeof(int));
+        if (periods == NULL) exit(EXIT_FAILURE);
+        for (int i = 0; i < partition.class_count; i++) {
+            if (is_transient[i]) continue;
+            t_matrix sub_matrix = create_sub_matrix(matrix, &partition, i);
+            periods[i] = get_period(sub_matrix);
+            free_matrix(sub_matrix);
+        }
+        free_matrix(matrix);
+    } else {
+        periods = get_class_periods(&graph, &partition, class_map);
+    }
+    for (int i = 0; i < partition.class_count; i++) {
+        if (is_transient[i]) continue;
+        printf("Classe %s : periode %d%s\n", partition.classes[i].name, periods[i], periods[i] == 1 ? " (aperiodique)" : "");
+    }
+    free(periods);
+    free(is_transient);
+
     FILE *output_name = fopen("hasse_output.mmd", "w");
     write_hasse_mermaid(&partition, &links, output_name);
     fclose(output_name);
     printf("\n Fichier 'hasse_output.mmd' genere.\n");
 
+
+    // PARTIE 3 : DISTRIBUTION STATIONNAIRE
+
+    if (compute_stationary) {
+        // Sans méthode imposée : GTH si le planificateur retient le dense (chaîne irréductible),
+        // puissance creuse sinon ; GTH demandé hors budget est remplacé par Arnoldi
+        t_plan plan = plan_analysis(&graph, ANALYSIS_STATIONARY);
+        printf("\n");
+        display_plan(&plan);
+        if (!stationary_method_given) {
+            stationary_method = plan.engine == ENGINE_DENSE && partition.class_count == 1 ? STATIONARY_GTH : STATIONARY_POWER;
+            if (plan.engine == ENGINE_DENSE && partition.class_count != 1) {
+                printf("Chaine reductible : GTH inapplicable, moteur creux.\n");
+            }
+        } else if (stationary_method == STATIONARY_GTH && plan.dense_bytes > plan.budget) {
+            printf("GTH demande hors budget : Arnoldi creux.\n");
+            stationary_method = STATIONARY_ARNOLDI;
+        }
+        printf(" Distribution stationnaire (%s)...\n", stationary_method == STATIONARY_GTH ? "elimination GTH"
+               : stationary_method == STATIONARY_ARNOLDI ? "Arnoldi" : "methode de la puissance creuse");
+        t_stationary stationary = find_stationary(&graph, stationary_method);
+        display_stationary(&stationary, 20);
+        free_stationary(&stationary);
+    }
+
+    if (power > 0) {
+        printf("\n Puissance %d de la matrice de transition...\n", power);
+        t_plan plan = plan_analysis(&graph, ANALYSIS_POWER);
+        display_plan(&plan);
+        if (plan.engine == ENGINE_DENSE) {
+            t_matrix matrix = create_matrix_from_graph(&graph);
+            t_matrix power_result = power_matrix(matrix, power);
+            display_matrix(power_result);
+            free_matrix(power_result);
+            free_matrix(matrix);
+        } else {
+            t_adj_list power_result = power_sparse(&graph, power, drop_tolerance);
+            display_sparse_matrix(&power_result, 20);
+            free_adjlist(&power_result);
+        }
+    }
+
+    if (compute_limit) {
+        printf("\n Matrice limite (par classes)...\n");
+        t_plan plan = plan_analysis(&graph, ANALYSIS_LIMIT);
+        display_plan(&plan);
+        if (plan.engine == ENGINE_DENSE) {
+            t_matrix matrix = create_matrix_from_graph(&graph);
+            t_matrix limit_matrix = compute_limit_matrix(matrix, &partition, &links);
+            display_matrix(limit_matrix);
+            free_matrix(limit_matrix);
+            free_matrix(matrix);
+        } else {
+            // L[i][j] = P(absorption de i dans la classe de j) * pi_j : seule la forme factorisée est calculée
+            printf("Matrice limite non formee : L[i][j] = P(absorption de i dans la classe de j) * pi_j.\n");
+            printf("Distributions stationnaires des classes fermees (pi_j)...\n");
+            t_class_stationary class_stationary = stationary_by_class(&graph, &partition, class_map, &links);
+            display_class_stationary(&class_stationary, &partition, 20);
+            free_class_stationary(&class_stationary);
+            compute_absorption_times = true;
+        }
+    }
+
+    if (compute_absorption_times) {
+        printf("\n Probabilites d'absorption et durees moyennes...\n");
+        t_absorption absorption = compute_absorption(&graph, &partition, class_map, &links, ABSORPTION_TOLERANCE, ABSORPTION_MAX_SWEEPS);
+        display_absorption(&absorption, &partition, 20);
+        free_absorption(&absorption);
+    }
+
+    if (compute_passage_times) {
+        printf("\n Temps moyens de premier passage vers l'etat %d...\n", passage_target);
+        if (partition.class_count != 1) {
+            printf("Le graphe n'est pas irreductible : temps de premier passage non definis.\n");
+        } else if (passage_target > graph.length) {
+            printf("L'etat %d n'existe pas (%d etats).\n", passage_target, graph.length);
+        } else {
+            t_passage passage = create_passage(&graph);
+            double *times = malloc(graph.length * sizeof(double));
+            if (times == NULL) exit(EXIT_FAILURE);
+            passage_times_to(&passage, passage_target - 1, times);
+            double kemeny_error;
+            double kemeny = kemeny_constant(&passage, PASSAGE_KEMENY_SAMPLES, &kemeny_error);
+            display_passage(&passage, times, passage_target - 1, kemeny, kemeny_error, 20);
+            free(times);
+            free_passage(&passage);
+        }
+    }
+
+    if (step_list != NULL) {
+        // États de départ (à partir de 1), séparés par des virgules
+        int start_count = 1;
+        for (const char *c = start_list; *c != '\0'; c++) {
+            if (*c == ',') start_count++;
+        }
+        int *start_states = malloc(start_count * sizeof(int));
+        if (start_states == NULL) exit(EXIT_FAILURE);
+        bool valid = true;
+        const char *cursor = start_list;
+        for (int c = 0; c < start_count && valid; c++) {
+            char *end;
+            long state = strtol(cursor, &end, 10);
+            valid = end != cursor && state >= 1 && state <= graph.length && (*end == ',' || *end == '\0');
+            start_states[c] = (int) state - 1;
+            cursor = end + 1;
+        }
+
+        if (!valid) {
+            printf("\nEtats de depart invalides : %s (%d etats).\n", start_list, graph.length);
+        } else {
+            t_propagator propagator = create_propagator(&graph);
+            // Un seul état : requête avec points de reprise ; plusieurs : un lot, un passage sur les arêtes par pas
+            t_propagation propagation;
+            t_batch batch;
+            double *distribution = NULL;
+            if (start_count == 1) {
+                propagation = create_propagation(&propagator, start_states[0]);
+            } else {
+                batch = create_batch(&propagator, start_states, start_count);
+                distribution = malloc((graph.length > 0 ? graph.length : 1) * sizeof(double));
+                if (distribution == NULL) exit(EXIT_FAILURE);
+            }
+
+            cursor = step_list;
+            while (*cursor != '\0') {
+                char *end;
+                long steps = strtol(cursor, &end, 10);
+                if (end == cursor || steps < 0 || steps > INT_MAX || (*end != ',' && *end != '\0')) {
+                    fprintf(stderr, "Nombre de pas invalide : %s\n", cursor);
+                    break;
+                }
+                if (start_count > 1) propagate_batch_to(&batch, (int) steps);
+                for (int c = 0; c < start_count; c++) {
+                    printf("\n Distribution apres %ld pas depuis l'etat %d...\n", steps, start_states[c] + 1);
+                    if (start_count > 1) {
+                        get_batch_distribution(&batch, c, distribution);
+                        display_distribution(distribution, graph.length, 20);
+                    } else {
+                        display_distribution(propagate_to(&propagation, (int) steps), graph.length, 20);
+                    }
+                }
+                cursor = *end == ',' ? end + 1 : end;
+            }
+            if (start_count == 1) printf("Produits vecteur-matrice effectues : %lld\n", propagation.products);
+
+            free(distribution);
+            if (start_count == 1) free_propagation(&propagation);
+            else free_batch(&batch);
+            free_propagator(&propagator);
+        }
+        free(start_states);
+    }
+
+    if (walk_count > 0) {
+        int walk_start = atoi(start_list);
+        printf("\n Marches aleatoires depuis l'etat %d...\n", walk_start);
+        if (walk_start < 1 || walk_start > graph.length || walk_target > graph.length) {
+            printf("Etat de depart ou cible invalide (%d etats).\n", graph.length);
+        } else {
+            t_alias_table alias_table = create_alias_table(&graph);
+            t_walk_result walk = random_walk(&alias_table, walk_start - 1, walk_count, walk_steps, walk_target - 1, seed);
+            display_walk_result(&walk, 20);
+            free_walk_result(&walk);
+            free_alias_table(&alias_table);
+        }
+    }
+
     free(class_map);
+    free_link_array(&links);
+    free_partition(&partition);
+    free_adjlist(&graph);
+    free_global_thread_pool();
 
     return 0;
 }
\ No newline at end of file
@@ -1,39 +1,108 @@
 #include "matrix.h"
+#include "threads.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define MATRIX_X86_SIMD
+#endif
+
+// Dimensions des blocs de la multiplication : KC lignes de B (~KC * NC * 4 octets en cache L2)
+#define GEMM_KC 256
+#define GEMM_NC 512
+
+// Nombre de pivots éliminés ensemble par gth_stationary
+#define GTH_PANEL 32
+
+static float *alloc_aligned_floats(size_t count) {
+    size_t bytes = count * sizeof(float);
+    if (bytes == 0) bytes = MATRIX_ALIGNMENT;
+#ifdef _WIN32
+    float *values = _aligned_malloc(bytes, MATRIX_ALIGNMENT);
+#else
+    float *values = aligned_alloc(MATRIX_ALIGNMENT, bytes);
+#endif
+    if (values == NULL) exit(EXIT_FAILURE);
+    return values;
+}
+
+static void free_aligned_floats(float *values) {
+#ifdef _WIN32
+    _aligned_free(values);
+#else
+    free(values);
+#endif
+}
+
+// Noyau de multiplication d'un bloc : C[i0..i1)[j0..j1) += A[i0..i1)[k0..k1) * B[k0..k1)[j0..j1)
+typedef void (*t_gemm_block)(t_matrix, t_matrix, t_matrix, int, int, int, int, int, int);
+
+// Contexte partagé des noyaux parallèles, découpés en blocs de lignes
+typedef struct s_matrix_task {
+    t_matrix result;                // Matrice écrite
+    t_matrix matrix_A;              // Première opérande
+    t_matrix matrix_B;              // Deuxième opérande
+    t_adj_list *graph;              // Graphe source (create_matrix_from_graph)
+    int rows_per_block;             // Nombre de lignes par tâche
+    double *partial_sums;           // Une somme partielle par tâche (diff_matrices)
+    t_gemm_block gemm_block;        // Noyau de multiplication choisi
+} t_matrix_task;
+
+// Découpe size lignes en blocs (multiples de multiple) pour le pool, et retourne le nombre de tâches
+static int split_rows(t_thread_pool *pool, int size, int multiple, t_matrix_task *task) {
+    int target_blocks = pool != NULL ? pool->thread_count * 4 : 1;
+    int rows = (size + target_blocks - 1) / target_blocks;
+    rows = (rows + multiple - 1) / multiple * multiple;
+    if (rows < 1) rows = 1;
+
+    task->rows_per_block = rows;
+    return (size + rows - 1) / rows;
+}
+
+static void task_rows(t_matrix_task *task, int size, int block, int *begin, int *end) {
+    *begin = block * task->rows_per_block;
+    *end = *begin + task->rows_per_block < size ? *begin + task->rows_per_block : size;
+}
+
 t_matrix create_empty_matrix(int size) {
     t_matrix matrix;
     matrix.size = size;
+    matrix.stride = (size + MATRIX_ROW_PADDING - 1) / MATRIX_ROW_PADDING * MATRIX_ROW_PADDING;
     
-    matrix.data = malloc(size * sizeof(float *));
+    matrix.values = alloc_aligned_floats((size_t) size * matrix.stride);
+    memset(matrix.values, 0, (size_t) size * matrix.stride * sizeof(float));
+
+    matrix.data = malloc((size > 0 ? size : 1) * sizeof(float *));
     if (matrix.data == NULL) exit(EXIT_FAILURE);
     
     for (int i = 0; i < size; i++) {
-        matrix.data[i] = calloc(size, sizeof(float)); 
-        if (matrix.data[i] == NULL) exit(EXIT_FAILURE); 
+        matrix.data[i] = matrix.values + (size_t) i * matrix.stride;
     }
 
     return matrix;
 }
 
+static void copy_rows_task(void *context, int block) {
+    t_matrix_task *task = context;
+    int begin, end;
+    task_rows(task, task->result.size, block, &begin, &end);
+
+    memcpy(task->result.data[begin], task->matrix_A.data[begin], (size_t) (end - begin) * task->result.stride * sizeof(float));
+}
+
 void copy_matrix(t_matrix dest_matrix, t_matrix from_matrix) {
     if (dest_matrix.size != from_matrix.size) return;
 
-    for (int i = 0; i < from_matrix.size; i++) {
-        for (int j = 0; j < from_matrix.size; j++) {
-            dest_matrix.data[i][j] = from_matrix.data[i][j];
-        }
-    }
+    t_thread_pool *pool = pool_for_work((long) from_matrix.size * from_matrix.size);
+    t_matrix_task task = { .result = dest_matrix, .matrix_A = from_matrix };
+    run_parallel(pool, split_rows(pool, from_matrix.size, 1, &task), copy_rows_task, &task);
 }
 
 void free_matrix(t_matrix matrix) {
-    for (int i = 0; i < matrix.size; i++) {
-        free(matrix.data[i]);
-    }
-
+    free_aligned_floats(matrix.values);
     free(matrix.data);
     matrix.size = 0;
 }
@@ -50,74 +119,308 @@ void display_matrix(t_matrix matrix) {
     }
 }
 
+static void graph_rows_task(void *context, int block) {
+    t_matrix_task *task = context;
+    int begin, end;
+    task_rows(task, task->result.size, block, &begin, &end);
+
+    for (int i = begin; i < end; i++) {
+        for (int edge = task->graph->offsets[i]; edge < task->graph->offsets[i + 1]; edge++) {
+            task->result.data[i][task->graph->dest[edge]] = task->graph->proba[edge];
+        }
+    }
+}
+
 t_matrix create_matrix_from_graph(t_adj_list *graph) {
     int size = graph->length;
     t_matrix matrix = create_empty_matrix(size);
-    
-    for (int i = 0; i < size; i++) {
-        t_cell *edge = graph->list[i].head;
 
-        while (edge != NULL) {
-            matrix.data[i][edge->dest] = edge->proba;
-            edge = edge->next;
+    t_thread_pool *pool = pool_for_work(size + (long) graph->edge_count);
+    t_matrix_task task = { .result = matrix, .graph = graph };
+    run_parallel(pool, split_rows(pool, size, 1, &task), graph_rows_task, &task);
+    return matrix;
+}
+
+// C[i][j0..j1) += A[i][k0..k1) * B[k0..k1)[j0..j1), lignes [i0, i1) : version scalaire
+static void gemm_block_scalar(t_matrix C, t_matrix A, t_matrix B, int i0, int i1, int k0, int k1, int j0, int j1) {
+    for (int i = i0; i < i1; i++) {
+        float *restrict c_row = C.data[i];
+        for (int k = k0; k < k1; k++) {
+            float a = A.data[i][k];
+            const float *restrict b_row = B.data[k];
+            for (int j = j0; j < j1; j++) {
+                c_row[j] += a * b_row[j];
+            }
         }
     }
-    return matrix;
+}
+
+#ifdef MATRIX_X86_SIMD
+
+// Micro-tuile AVX2 de 6 lignes x 16 colonnes : 12 accumulateurs en registres
+__attribute__((target("avx2,fma")))
+static void gemm_block_avx2(t_matrix C, t_matrix A, t_matrix B, int i0, int i1, int k0, int k1, int j0, int j1) {
+    int i = i0;
+
+    for (; i + 6 <= i1; i += 6) {
+        for (int j = j0; j < j1; j += 16) {
+            __m256 acc[6][2];
+            for (int r = 0; r < 6; r++) {
+                acc[r][0] = _mm256_load_ps(&C.data[i + r][j]);
+                acc[r][1] = _mm256_load_ps(&C.data[i + r][j + 8]);
+            }
+            for (int k = k0; k < k1; k++) {
+                __m256 b0 = _mm256_load_ps(&B.data[k][j]);
+                __m256 b1 = _mm256_load_ps(&B.data[k][j + 8]);
+                for (int r = 0; r < 6; r++) {
+                    __m256 a = _mm256_broadcast_ss(&A.data[i + r][k]);
+                    acc[r][0] = _mm256_fmadd_ps(a, b0, acc[r][0]);
+                    acc[r][1] = _mm256_fmadd_ps(a, b1, acc[r][1]);
+                }
+            }
+            for (int r = 0; r < 6; r++) {
+                _mm256_store_ps(&C.data[i + r][j], acc[r][0]);
+                _mm256_store_ps(&C.data[i + r][j + 8], acc[r][1]);
+            }
+        }
+    }
+
+    for (; i < i1; i++) {
+        for (int j = j0; j < j1; j += 16) {
+            __m256 acc0 = _mm256_load_ps(&C.data[i][j]);
+            __m256 acc1 = _mm256_load_ps(&C.data[i][j + 8]);
+            for (int k = k0; k < k1; k++) {
+                __m256 a = _mm256_broadcast_ss(&A.data[i][k]);
+                acc0 = _mm256_fmadd_ps(a, _mm256_load_ps(&B.data[k][j]), acc0);
+                acc1 = _mm256_fmadd_ps(a, _mm256_load_ps(&B.data[k][j + 8]), acc1);
+            }
+            _mm256_store_ps(&C.data[i][j], acc0);
+            _mm256_store_ps(&C.data[i][j + 8], acc1);
+        }
+    }
+}
+
+// Micro-tuile AVX-512 de 12 lignes x 16 colonnes : 12 accumulateurs en registres
+__attribute__((target("avx512f")))
+static void gemm_block_avx512(t_matrix C, t_matrix A, t_matrix B, int i0, int i1, int k0, int k1, int j0, int j1) {
+    int i = i0;
+
+    for (; i + 12 <= i1; i += 12) {
+        for (int j = j0; j < j1; j += 16) {
+            __m512 acc[12];
+            for (int r = 0; r < 12; r++) {
+                acc[r] = _mm512_load_ps(&C.data[i + r][j]);
+            }
+            for (int k = k0; k < k1; k++) {
+                __m512 b = _mm512_load_ps(&B.data[k][j]);
+                for (int r = 0; r < 12; r++) {
+                    acc[r] = _mm512_fmadd_ps(_mm512_set1_ps(A.data[i + r][k]), b, acc[r]);
+                }
+            }
+            for (int r = 0; r < 12; r++) {
+                _mm512_store_ps(&C.data[i + r][j], acc[r]);
+            }
+        }
+    }
+
+    for (; i < i1; i++) {
+        for (int j = j0; j < j1; j += 16) {
+            __m512 acc = _mm512_load_ps(&C.data[i][j]);
+            for (int k = k0; k < k1; k++) {
+                acc = _mm512_fmadd_ps(_mm512_set1_ps(A.data[i][k]), _mm512_load_ps(&B.data[k][j]), acc);
+            }
+            _mm512_store_ps(&C.data[i][j], acc);
+        }
+    }
+}
+
+#endif
+
+static t_gemm_block select_gemm_block(void) {
+#ifdef MATRIX_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return gemm_block_avx512;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return gemm_block_avx2;
+#endif
+    return gemm_block_scalar;
+}
+
+// C[i0..i1) = A[i0..i1) * B, par blocs de KC x NC de B ; les colonnes de remplissage de B
+// étant nulles, les tuiles couvrent toute la largeur stride sans cas particulier
+static void gemm_rows(t_gemm_block gemm_block, t_matrix C, t_matrix A, t_matrix B, int i0, int i1) {
+    memset(C.data[i0], 0, (size_t) (i1 - i0) * C.stride * sizeof(float));
+
+    for (int k0 = 0; k0 < A.size; k0 += GEMM_KC) {
+        int k1 = k0 + GEMM_KC < A.size ? k0 + GEMM_KC : A.size;
+        for (int j0 = 0; j0 < C.stride; j0 += GEMM_NC) {
+            int j1 = j0 + GEMM_NC < C.stride ? j0 + GEMM_NC : C.stride;
+            gemm_block(C, A, B, i0, i1, k0, k1, j0, j1);
+        }
+    }
+}
+
+static void gemm_rows_task(void *context, int block) {
+    t_matrix_task *task = context;
+    int begin, end;
+    task_rows(task, task->result.size, block, &begin, &end);
+
+    gemm_rows(task->gemm_block, task->result, task->matrix_A, task->matrix_B, begin, end);
+}
+
+// Noyau choisi une seule fois, même si plusieurs threads multiplient pour la première fois en même temps
+static pthread_once_t gemm_block_once = PTHREAD_ONCE_INIT;
+static t_gemm_block gemm_block;
+
+static void init_gemm_block(void) {
+    gemm_block = select_gemm_block();
+}
+
+void multiply_matrices_into(t_matrix result_matrix, t_matrix matrix_A, t_matrix matrix_B) {
+    if (matrix_A.size != matrix_B.size || result_matrix.size != matrix_A.size) exit(EXIT_FAILURE);
+    if (matrix_A.size == 0) return;
+
+    pthread_once(&gemm_block_once, init_gemm_block);
+
+    // Blocs de lignes multiples de 12 (hauteur des micro-tuiles), un bloc par tâche
+    t_thread_pool *pool = matrix_A.size >= 64 ? get_thread_pool() : NULL;
+    t_matrix_task task = { .result = result_matrix, .matrix_A = matrix_A, .matrix_B = matrix_B, .gemm_block = gemm_block };
+    run_parallel(pool, split_rows(pool, matrix_A.size, 12, &task), gemm_rows_task, &task);
 }
 
 t_matrix multiply_matrices(t_matrix matrix_A, t_matrix matrix_B) {
     if (matrix_A.size != matrix_B.size) exit(EXIT_FAILURE);
     
     t_matrix result_matrix = create_empty_matrix(matrix_A.size);
-    
-    for (int i = 0; i < matrix_A.size; i++) {
+    multiply_matrices_into(result_matrix, matrix_A, matrix_B);
+    return result_matrix;
+}
 
-        for (int j = 0; j < matrix_A.size; j++) {
-            float sum = 0.0f;
+static void diff_rows_task(void *context, int block) {
+    t_matrix_task *task = context;
+    int begin, end;
+    double diff = 0.0;
+    task_rows(task, task->matrix_A.size, block, &begin, &end);
 
-            for (int k = 0; k < matrix_A.size; k++) {
-                sum += matrix_A.data[i][k] * matrix_B.data[k][j];
-            }
-            result_matrix.data[i][j] = sum;
+    for (int i = begin; i < end; i++) {
+        for (int j = 0; j < task->matrix_A.size; j++) {
+            diff += fabs(task->matrix_A.data[i][j] - task->matrix_B.data[i][j]);
         }
     }
-    return result_matrix;
+    task->partial_sums[block] = diff;
 }
 
 float diff_matrices(t_matrix matrix_A, t_matrix matrix_B) {
     if (matrix_A.size != matrix_B.size) return -1.0f;
 
-    float diff = 0.0f;
+    t_thread_pool *pool = pool_for_work((long) matrix_A.size * matrix_A.size);
+    t_matrix_task task = { .matrix_A = matrix_A, .matrix_B = matrix_B };
+    int block_count = split_rows(pool, matrix_A.size, 1, &task);
+
+    task.partial_sums = calloc(block_count > 0 ? block_count : 1, sizeof(double));
+    if (task.partial_sums == NULL) exit(EXIT_FAILURE);
+    run_parallel(pool, block_count, diff_rows_task, &task);
+
+    // Sommes partielles additionnées dans l'ordre : résultat indépendant du nombre de threads
+    double diff = 0.0;
+    for (int b = 0; b < block_count; b++) {
+        diff += task.partial_sums[b];
+    }
+    free(task.partial_sums);
+    return (float) diff;
+}
+
+t_matrix_workspace create_matrix_workspace(int size) {
+    t_matrix_workspace workspace;
+    workspace.size = size;
+
+    for (int i = 0; i < MATRIX_WORKSPACE_BUFFERS; i++) {
+        workspace.buffers[i] = create_empty_matrix(size);
+    }
+    return workspace;
+}
+
+void free_matrix_workspace(t_matrix_workspace *workspace) {
+    for (int i = 0; i < MATRIX_WORKSPACE_BUFFERS; i++) {
+        free_matrix(workspace->buffers[i]);
+    }
+    workspace->size = 0;
+}
+
+void power_matrix_into(t_matrix result_matrix, t_matrix matrix, int p, t_matrix_workspace *workspace) {
+    if (result_matrix.size != matrix.size) exit(EXIT_FAILURE);
+
+    if (p < 1) {
+        memset(result_matrix.values, 0, (size_t) result_matrix.size * result_matrix.stride * sizeof(float));
+        return;
+    }
+
+    t_matrix_workspace local_workspace;
+    if (workspace == NULL || workspace->size != matrix.size) {
+        local_workspace = create_matrix_workspace(matrix.size);
+        workspace = &local_workspace;
+    }
+
+    // Exponentiation rapide : square parcourt M, M^2, M^4, ... et acc accumule les puissances
+    // des bits à 1 de p ; les pointeurs tournent entre les tampons, sans allocation
+    t_matrix *square = &workspace->buffers[0];
+    t_matrix *square_next = &workspace->buffers[1];
+    t_matrix *acc = &result_matrix;
+    t_matrix *acc_next = &workspace->buffers[2];
+    bool first = true;
+
+    copy_matrix(*square, matrix);
+
+    while (p > 0) {
+        if (p & 1) {
+            if (first) {
+                copy_matrix(*acc, *square);
+                first = false;
+            } else {
+                multiply_matrices_into(*acc_next, *acc, *square);
+                t_matrix *swap = acc;
+                acc = acc_next;
+                acc_next = swap;
+            }
+        }
 
-    for (int i = 0; i < matrix_A.size; i++) {
-        for (int j = 0; j < matrix_A.size; j++) {
-            diff += fabs(matrix_A.data[i][j] - matrix_B.data[i][j]);
+        p >>= 1;
+        if (p > 0) {
+            multiply_matrices_into(*square_next, *square, *square);
+            t_matrix *swap = square;
+            square = square_next;
+            square_next = swap;
         }
     }
-    return diff;
+
+    if (acc->values != result_matrix.values) copy_matrix(result_matrix, *acc);
+    if (workspace == &local_workspace) free_matrix_workspace(&local_workspace);
 }
 
 t_matrix power_matrix(t_matrix matrix, int p) {
-    if (p < 1) return create_empty_matrix(matrix.size); 
-    
     t_matrix result_matrix = create_empty_matrix(matrix.size);
-    copy_matrix(result_matrix, matrix);
-    
-    if (p == 1) {
-        return result_matrix;
+    power_matrix_into(result_matrix, matrix, p, NULL);
+    return result_matrix;
+}
+
+// dest += scale * from, sur toutes les cases (colonnes de remplissage comprises, qui restent nulles)
+static void add_scaled_matrix(t_matrix dest_matrix, t_matrix from_matrix, float scale) {
+    size_t count = (size_t) dest_matrix.size * dest_matrix.stride;
+    for (size_t i = 0; i < count; i++) {
+        dest_matrix.values[i] += scale * from_matrix.values[i];
     }
-    
-    t_matrix temp_matrix = create_empty_matrix(matrix.size);
-    
-    for (int i = 2; i <= p; i++) {
-        copy_matrix(temp_matrix, result_matrix);
-        t_matrix new_matrix_result = multiply_matrices(temp_matrix, matrix);
-        free_matrix(result_matrix);
-        result_matrix = new_matrix_result;
+}
+
+// Graphe des cases non nulles d'une matrice, pour les algorithmes de classes en O(V + E)
+static t_adj_list create_graph_from_matrix(t_matrix matrix) {
+    t_edge_list edges = create_edge_list(matrix.size > 0 ? matrix.size : 1);
+    for (int i = 0; i < matrix.size; i++) {
+        for (int j = 0; j < matrix.size; j++) {
+            if (matrix.data[i][j] > 0.0f) edge_list_add(&edges, i, j, matrix.data[i][j]);
+        }
     }
-    
-    free_matrix(temp_matrix);
-    return result_matrix;
+    t_adj_list graph = build_adjlist(matrix.size, &edges);
+    free_edge_list(&edges);
+    return graph;
 }
 
 t_matrix find_stationary_matrix(t_matrix matrix, float epsilon) {
@@ -125,26 +428,416 @@ t_matrix find_stationary_matrix(t_matrix matrix, float epsilon) {
     int power = 1;
     float diff = INFINITY;
     
-    t_matrix prev_matrix = create_empty_matrix(size);
-    copy_matrix(prev_matrix, matrix);
-    
+    // Deux tampons alternés : M^n et M^(n+1)
     t_matrix curr_matrix = create_empty_matrix(size);
     copy_matrix(curr_matrix, matrix);
     
+    t_matrix next_matrix = create_empty_matrix(size);
+
+    // Chaîne périodique : M^n oscille sans converger. On itère alors sur la moyenne de Cesàro
+    // A_n = (M^n + ... + M^(n+d-1)) / d, qui vérifie A_(n+1) = A_n M et converge aussi vite
+    // que M^n pour une chaîne apériodique (les valeurs propres de module 1 s'annulent dans la moyenne).
+    // d est le ppcm des périodes des classes fermées, y compris celles que l'état 0 n'atteint pas.
+    t_adj_list graph = create_graph_from_matrix(matrix);
+    int period = get_chain_period(&graph, MATRIX_MAX_CESARO_PERIOD);
+    free_adjlist(&graph);
+
+    // Période trop grande : chaîne paresseuse (I + M) / 2, apériodique et de même limite de Cesàro
+    t_matrix lazy_matrix = create_empty_matrix(0);
+    if (period == 0) {
+        lazy_matrix = create_empty_matrix(size);
+        add_scaled_matrix(lazy_matrix, matrix, 0.5f);
+        for (int i = 0; i < size; i++) {
+            lazy_matrix.data[i][i] += 0.5f;
+        }
+        matrix = lazy_matrix;
+        copy_matrix(curr_matrix, matrix);
+    }
+
+    if (period > 1) {
+        t_matrix power_term = create_empty_matrix(size);
+        copy_matrix(power_term, matrix);
+        float scale = 1.0f / period;
+        memset(curr_matrix.values, 0, (size_t) size * curr_matrix.stride * sizeof(float));
+        add_scaled_matrix(curr_matrix, power_term, scale);
+
+        for (int k = 1; k < period; k++) {
+            power++;
+            multiply_matrices_into(next_matrix, power_term, matrix);
+            t_matrix swap = power_term;
+            power_term = next_matrix;
+            next_matrix = swap;
+            add_scaled_matrix(curr_matrix, power_term, scale);
+        }
+        free_matrix(power_term);
+    }
+    
     while (diff > epsilon && power < 1000) { 
         power++;
-        t_matrix next_matrix = multiply_matrices(curr_matrix, matrix);
+        multiply_matrices_into(next_matrix, curr_matrix, matrix);
         diff = diff_matrices(next_matrix, curr_matrix);
-        free_matrix(prev_matrix);
-        prev_matrix = curr_matrix;
+
+        t_matrix swap = curr_matrix;
         curr_matrix = next_matrix;
+        next_matrix = swap;
     }
     
-    free_matrix(prev_matrix); 
-    printf("Convergence trouvee a la puissance n=%d.\n", power);
+    free_matrix(next_matrix); 
+    free_matrix(lazy_matrix);
+    if (period > 1) {
+        printf("Chaine de periode %d : convergence de la moyenne de Cesaro a la puissance n=%d.\n", period, power);
+    } else if (period == 0) {
+        printf("Chaine periodique (ppcm des periodes > %d) : convergence de (I + M) / 2 a la puissance n=%d.\n", MATRIX_MAX_CESARO_PERIOD, power);
+    } else {
+        printf("Convergence trouvee a la puissance n=%d.\n", power);
+    }
     return curr_matrix;
 }
 
+// Mise à jour différée de GTH : a_ij += somme des a_ik * a_kj, k dans le panneau, i dans [i0, i1), j < leading
+typedef void (*t_gth_update)(double *, int, int, int, int, int);
+
+// Version scalaire, colonnes [j0, leading) des lignes [i0, i1)
+static void gth_update_columns(double *values, int stride, int i0, int i1, int j0, int leading, int panel_end) {
+    for (int i = i0; i < i1; i++) {
+        double *restrict row = values + (size_t) i * stride;
+        for (int k = leading; k < panel_end; k++) {
+            const double *restrict pivot_row = values + (size_t) k * stride;
+            double factor = row[k];
+            for (int j = j0; j < leading; j++) row[j] += factor * pivot_row[j];
+        }
+    }
+}
+
+static void gth_update_scalar(double *values, int stride, int i0, int i1, int leading, int panel_end) {
+    gth_update_columns(values, stride, i0, i1, 0, leading, panel_end);
+}
+
+#ifdef MATRIX_X86_SIMD
+
+// Tuile AVX2 de 4 lignes x 8 colonnes : 8 accumulateurs en registres pendant tout le panneau
+__attribute__((target("avx2,fma")))
+static void gth_update_avx2(double *values, int stride, int i0, int i1, int leading, int panel_end) {
+    int i = i0;
+
+    for (; i + 4 <= i1; i += 4) {
+        int j = 0;
+        for (; j + 8 <= leading; j += 8) {
+            __m256d acc[4][2];
+            for (int r = 0; r < 4; r++) {
+                acc[r][0] = _mm256_loadu_pd(values + (size_t) (i + r) * stride + j);
+                acc[r][1] = _mm256_loadu_pd(values + (size_t) (i + r) * stride + j + 4);
+            }
+            for (int k = leading; k < panel_end; k++) {
+                const double *pivot_row = values + (size_t) k * stride + j;
+                __m256d b0 = _mm256_loadu_pd(pivot_row);
+                __m256d b1 = _mm256_loadu_pd(pivot_row + 4);
+                for (int r = 0; r < 4; r++) {
+                    __m256d factor = _mm256_broadcast_sd(values + (size_t) (i + r) * stride + k);
+                    acc[r][0] = _mm256_fmadd_pd(factor, b0, acc[r][0]);
+                    acc[r][1] = _mm256_fmadd_pd(factor, b1, acc[r][1]);
+                }
+            }
+            for (int r = 0; r < 4; r++) {
+                _mm256_storeu_pd(values + (size_t) (i + r) * stride + j, acc[r][0]);
+                _mm256_storeu_pd(values + (size_t) (i + r) * stride + j + 4, acc[r][1]);
+            }
+        }
+        gth_update_columns(values, stride, i, i + 4, j, leading, panel_end);
+    }
+    gth_update_columns(values, stride, i, i1, 0, leading, panel_end);
+}
+
+// Tuile AVX-512 de 4 lignes x 16 colonnes
+__attribute__((target("avx512f")))
+static void gth_update_avx512(double *values, int stride, int i0, int i1, int leading, int panel_end) {
+    int i = i0;
+
+    for (; i + 4 <= i1; i += 4) {
+        int j = 0;
+        for (; j + 16 <= leading; j += 16) {
+            __m512d acc[4][2];
+            for (int r = 0; r < 4; r++) {
+                acc[r][0] = _mm512_loadu_pd(values + (size_t) (i + r) * stride + j);
+                acc[r][1] = _mm512_loadu_pd(values + (size_t) (i + r) * stride + j + 8);
+            }
+            for (int k = leading; k < panel_end; k++) {
+                const double *pivot_row = values + (size_t) k * stride + j;
+                __m512d b0 = _mm512_loadu_pd(pivot_row);
+                __m512d b1 = _mm512_loadu_pd(pivot_row + 8);
+                for (int r = 0; r < 4; r++) {
+                    __m512d factor = _mm512_set1_pd(values[(size_t) (i + r) * stride + k]);
+                    acc[r][0] = _mm512_fmadd_pd(factor, b0, acc[r][0]);
+                    acc[r][1] = _mm512_fmadd_pd(factor, b1, acc[r][1]);
+                }
+            }
+            for (int r = 0; r < 4; r++) {
+                _mm512_storeu_pd(values + (size_t) (i + r) * stride + j, acc[r][0]);
+                _mm512_storeu_pd(values + (size_t) (i + r) * stride + j + 8, acc[r][1]);
+            }
+        }
+        gth_update_columns(values, stride, i, i + 4, j, leading, panel_end);
+    }
+    gth_update_columns(values, stride, i, i1, 0, leading, panel_end);
+}
+
+#endif
+
+static t_gth_update select_gth_update(void) {
+#ifdef MATRIX_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return gth_update_avx512;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return gth_update_avx2;
+#endif
+    return gth_update_scalar;
+}
+
+// Contexte partagé de l'élimination GTH, en double, lignes de longueur stride
+typedef struct s_gth_task {
+    double *values;                 // Matrice en cours d'élimination
+    int stride;                     // Longueur d'une ligne
+    int leading;                    // Nombre de lignes du bloc de tête (avant le panneau)
+    int panel_end;                  // Fin du panneau [leading, panel_end)
+    const double *pivot_sums;       // Somme hors diagonale de la ligne de chaque pivot du panneau
+    t_gth_update gth_update;        // Noyau de mise à jour choisi
+    t_matrix_task rows;             // Découpage des lignes du bloc de tête
+} t_gth_task;
+
+// Applique l'élimination des pivots du panneau aux lignes du bloc de tête
+static void gth_rows_task(void *context, int block) {
+    t_gth_task *task = context;
+    int begin, end;
+    task_rows(&task->rows, task->leading, block, &begin, &end);
+    int leading = task->leading;
+
+    for (int i = begin; i < end; i++) {
+        double *restrict row = task->values + (size_t) i * task->stride;
+
+        // Colonnes du panneau, pivot par pivot
+        for (int k = task->panel_end - 1; k >= leading; k--) {
+            const double *pivot_row = task->values + (size_t) k * task->stride;
+            row[k] /= task->pivot_sums[k - leading];
+            for (int j = leading; j < k; j++) row[j] += row[k] * pivot_row[j];
+        }
+
+    }
+
+    // Colonnes du bloc de tête : mise à jour de rang (taille du panneau) différée
+    task->gth_update(task->values, task->stride, begin, end, leading, task->panel_end);
+}
+
+double *gth_stationary(t_matrix matrix) {
+    int size = matrix.size;
+    if (size == 0) return NULL;
+
+    int stride = (size + 7) / 8 * 8;
+    double *values = malloc((size_t) size * stride * sizeof(double));
+    double *pivot_sums = malloc(GTH_PANEL * sizeof(double));
+    double *distribution = malloc(size * sizeof(double));
+    if (values == NULL || pivot_sums == NULL || distribution == NULL) exit(EXIT_FAILURE);
+
+    for (int i = 0; i < size; i++) {
+        for (int j = 0; j < size; j++) {
+            values[(size_t) i * stride + j] = matrix.data[i][j];
+        }
+    }
+
+    t_gth_update gth_update = select_gth_update();
+
+    // Élimination des états size-1, ..., 1 par panneaux de GTH_PANEL pivots. Le pivot 1 - p_kk est
+    // remplacé par la somme hors diagonale de la ligne : aucune soustraction, donc pas d'annulation.
+    bool reducible = false;
+    for (int panel_end = size; panel_end > 1 && !reducible; panel_end -= GTH_PANEL) {
+        int leading = panel_end - GTH_PANEL > 1 ? panel_end - GTH_PANEL : 1;
+
+        // Lignes du panneau (séquentiel, O(taille du panneau^2 * size))
+        for (int k = panel_end - 1; k >= leading; k--) {
+            double *pivot_row = values + (size_t) k * stride;
+            double sum = 0.0;
+            for (int j = 0; j < k; j++) sum += pivot_row[j];
+            if (sum <= 0.0) {
+                reducible = true;
+                break;
+            }
+            pivot_sums[k - leading] = sum;
+
+            for (int i = leading; i < k; i++) {
+                double *row = values + (size_t) i * stride;
+                row[k] /= sum;
+                for (int j = 0; j < k; j++) row[j] += row[k] * pivot_row[j];
+            }
+        }
+        if (reducible) break;
+
+        // Lignes du bloc de tête, en parallèle
+        t_thread_pool *pool = pool_for_work((long) leading * leading * (panel_end - leading));
+        t_gth_task task = { .values = values, .stride = stride, .leading = leading,
+                            .panel_end = panel_end, .pivot_sums = pivot_sums, .gth_update = gth_update };
+        run_parallel(pool, split_rows(pool, leading, 1, &task.rows), gth_rows_task, &task);
+    }
+
+    if (reducible) {
+        free(values);
+        free(pivot_sums);
+        free(distribution);
+        return NULL;
+    }
+
+    // Remontée : pi_0 = 1, pi_k = somme des pi_i * a_ik (i < k), puis normalisation
+    double total = distribution[0] = 1.0;
+    for (int k = 1; k < size; k++) {
+        double sum = 0.0;
+        for (int i = 0; i < k; i++) sum += distribution[i] * values[(size_t) i * stride + k];
+        distribution[k] = sum;
+        total += sum;
+    }
+    for (int k = 0; k < size; k++) distribution[k] /= total;
+
+    free(values);
+    free(pivot_sums);
+    return distribution;
+}
+
+// Résout A X = B en place (élimination de Gauss avec pivot partiel, en double) :
+// a est n x n, b est n x rhs_count et reçoit X
+static void solve_dense_system(double *a, int n, double *b, int rhs_count) {
+    for (int c = 0; c < n; c++) {
+        int best = c;
+        for (int i = c + 1; i < n; i++) {
+            if (fabs(a[(size_t) i * n + c]) > fabs(a[(size_t) best * n + c])) best = i;
+        }
+        if (best != c) {
+            for (int j = 0; j < n; j++) {
+                double swap = a[(size_t) c * n + j];
+                a[(size_t) c * n + j] = a[(size_t) best * n + j];
+                a[(size_t) best * n + j] = swap;
+            }
+            for (int j = 0; j < rhs_count; j++) {
+                double swap = b[(size_t) c * rhs_count + j];
+                b[(size_t) c * rhs_count + j] = b[(size_t) best * rhs_count + j];
+                b[(size_t) best * rhs_count + j] = swap;
+            }
+        }
+
+        double pivot = a[(size_t) c * n + c];
+        for (int i = c + 1; i < n; i++) {
+            double factor = a[(size_t) i * n + c] / pivot;
+            if (factor == 0.0) continue;
+            for (int j = c; j < n; j++) a[(size_t) i * n + j] -= factor * a[(size_t) c * n + j];
+            for (int j = 0; j < rhs_count; j++) b[(size_t) i * rhs_count + j] -= factor * b[(size_t) c * rhs_count + j];
+        }
+    }
+
+    for (int i = n - 1; i >= 0; i--) {
+        for (int j = 0; j < rhs_count; j++) {
+            double sum = b[(size_t) i * rhs_count + j];
+            for (int k = i + 1; k < n; k++) sum -= a[(size_t) i * n + k] * b[(size_t) k * rhs_count + j];
+            b[(size_t) i * rhs_count + j] = sum / a[(size_t) i * n + i];
+        }
+    }
+}
+
+t_matrix compute_limit_matrix(t_matrix matrix, t_partition *partition, t_link_array *link_array) {
+    int size = matrix.size;
+    int class_count = partition->class_count;
+    t_matrix limit_matrix = create_empty_matrix(size);
+    if (size == 0) return limit_matrix;
+
+    int *class_map = create_class_map(partition, size);
+    bool *is_transient = find_transient_classes(partition, link_array);
+    int *order = topological_sort_classes(link_array, class_count);
+    int *closed_index = malloc(class_count * sizeof(int));
+    int *local_index = malloc(size * sizeof(int));
+    double **closed_pi = malloc(class_count * sizeof(double *));
+    if (order == NULL || closed_index == NULL || local_index == NULL || closed_pi == NULL) exit(EXIT_FAILURE);
+
+    for (int c = 0; c < class_count; c++) {
+        for (int i = 0; i < partition->classes[c].vertex_count; i++) {
+            local_index[partition->classes[c].vertex_ids[i] - 1] = i;
+        }
+    }
+
+    // Classes fermées : distribution stationnaire de chacune, indépendamment (GTH sur sa sous-matrice)
+    int closed_count = 0;
+    for (int c = 0; c < class_count; c++) {
+        closed_pi[c] = NULL;
+        closed_index[c] = -1;
+        if (is_transient[c]) continue;
+
+        closed_index[c] = closed_count++;
+        t_matrix sub_matrix = create_sub_matrix(matrix, partition, c);
+        closed_pi[c] = gth_stationary(sub_matrix);
+        free_matrix(sub_matrix);
+        if (closed_pi[c] == NULL) exit(EXIT_FAILURE);
+    }
+
+    // absorption[i][k] : probabilité d'atteindre la k-ième classe fermée depuis l'état i
+    double *absorption = calloc((size_t) size * closed_count, sizeof(double));
+    if (absorption == NULL) exit(EXIT_FAILURE);
+    for (int i = 0; i < size; i++) {
+        int k = closed_index[class_map[i]];
+        if (k >= 0) absorption[(size_t) i * closed_count + k] = 1.0;
+    }
+
+    // Classes transitoires dans l'ordre topologique inverse : les classes en aval sont résolues
+    // avant, et chaque classe S donne un petit système (I - P_SS) A_S = P_S,aval A_aval
+    for (int t = class_count - 1; t >= 0; t--) {
+        int c = order[t];
+        if (!is_transient[c]) continue;
+
+        t_classe *class = &partition->classes[c];
+        int n = class->vertex_count;
+        double *system = malloc((size_t) n * n * sizeof(double));
+        double *rhs = calloc((size_t) n * (closed_count > 0 ? closed_count : 1), sizeof(double));
+        if (system == NULL || rhs == NULL) exit(EXIT_FAILURE);
+
+        for (int r = 0; r < n; r++) {
+            const float *row = matrix.data[class->vertex_ids[r] - 1];
+            for (int q = 0; q < n; q++) system[(size_t) r * n + q] = r == q ? 1.0 : 0.0;
+
+            for (int j = 0; j < size; j++) {
+                if (row[j] == 0.0f) continue;
+                if (class_map[j] == c) {
+                    system[(size_t) r * n + local_index[j]] -= row[j];
+                } else {
+                    for (int k = 0; k < closed_count; k++) {
+                        rhs[(size_t) r * closed_count + k] += row[j] * absorption[(size_t) j * closed_count + k];
+                    }
+                }
+            }
+        }
+
+        solve_dense_system(system, n, rhs, closed_count);
+        for (int r = 0; r < n; r++) {
+            memcpy(&absorption[(size_t) (class->vertex_ids[r] - 1) * closed_count], &rhs[(size_t) r * closed_count],
+                   closed_count * sizeof(double));
+        }
+        free(rhs);
+        free(system);
+    }
+
+    // Limite : L[i][j] = absorption[i][classe de j] * pi_classe(j) pour j dans une classe fermée
+    for (int i = 0; i < size; i++) {
+        for (int j = 0; j < size; j++) {
+            int k = closed_index[class_map[j]];
+            if (k < 0) continue;
+            limit_matrix.data[i][j] = (float) (absorption[(size_t) i * closed_count + k] * closed_pi[class_map[j]][local_index[j]]);
+        }
+    }
+
+    for (int c = 0; c < class_count; c++) {
+        free(closed_pi[c]);
+    }
+    free(absorption);
+    free(closed_pi);
+    free(local_index);
+    free(closed_index);
+    free(order);
+    free(is_transient);
+    free(class_map);
+    return limit_matrix;
+}
+
 t_matrix create_sub_matrix(t_matrix matrix, t_partition *partition, int class_index) {
     t_classe *class = &partition->classes[class_index];
     int sub_matrix_size = class->vertex_count;
@@ -174,50 +867,111 @@ int gcd(int x, int y) {
     return x;
 }
 
-int get_period(t_matrix sub_matrix) {
-    int size = sub_matrix.size;
-    if (size == 0) return 0;
-    
-    int *periods = malloc(size * sizeof(int));
-    if (periods == NULL) exit(EXIT_FAILURE); 
-    int period_count = 0;
-    
-    t_matrix power_matrix = create_empty_matrix(size);
-    t_matrix result_matrix = create_empty_matrix(size);
-    copy_matrix(power_matrix, sub_matrix);
-    
-    for (int p = 1; p <= size * 2; p++) { 
-        int diag_non_zero = 0;
-        
-        for (int i = 0; i < size; i++) {
-            if (power_matrix.data[i][i] > 0.00001f) { 
-                diag_non_zero = 1;
-                break;
+// Parcours en largeur d'une classe depuis root : niveaux dans level (à -1 au départ), et
+// PGCD des level[u] + 1 - level[v] sur les arêtes u -> v internes, qui est la période
+static int class_period(t_adj_list *graph, int *class_map, int class_index, int root, int *level, int *queue) {
+    int head = 0, tail = 0, period = 0;
+    level[root] = 0;
+    queue[tail++] = root;
+
+    while (head < tail) {
+        int u = queue[head++];
+        for (int e = graph->offsets[u]; e < graph->offsets[u + 1]; e++) {
+            int v = graph->dest[e];
+            if (class_map[v] != class_index || graph->proba[e] <= 0.0f) continue;
+
+            if (level[v] < 0) {
+                level[v] = level[u] + 1;
+                queue[tail++] = v;
+            } else {
+                period = gcd(period, abs(level[u] + 1 - level[v]));
             }
         }
-        
-        if (diag_non_zero) {
-            periods[period_count++] = p;
-        }
-    
-    
-        t_matrix temp = multiply_matrices(power_matrix, sub_matrix);
-        copy_matrix(power_matrix, temp); 
-        free_matrix(temp);
     }
-    
-    int result = 0;
+    return period;
+}
+
+int *get_class_periods(t_adj_list *graph, t_partition *partition, int *class_map) {
+    int *periods = malloc((partition->class_count > 0 ? partition->class_count : 1) * sizeof(int));
+    int *level = malloc((graph->length > 0 ? graph->length : 1) * sizeof(int));
+    int *queue = malloc((graph->length > 0 ? graph->length : 1) * sizeof(int));
+    if (periods == NULL || level == NULL || queue == NULL) exit(EXIT_FAILURE);
+
+    for (int i = 0; i < graph->length; i++) {
+        level[i] = -1;
+    }
 
-    if(period_count > 0) {
-        result = periods[0];
-        for (int i = 1; i < period_count; i++) {
-            result = gcd(result, periods[i]);
+    // Chaque sommet et chaque arête sont vus une fois : O(V + E) pour toutes les classes
+    for (int c = 0; c < partition->class_count; c++) {
+        t_classe *class = &partition->classes[c];
+        periods[c] = class->vertex_count > 0
+                   ? class_period(graph, class_map, c, class->vertex_ids[0] - 1, level, queue)
+                   : 0;
+    }
+
+    free(queue);
+    free(level);
+    return periods;
+}
+
+int get_chain_period(t_adj_list *graph, int limit) {
+    t_partition partition = tarjan(graph);
+    int *class_map = create_class_map(&partition, graph->length);
+    t_link_array links = find_class_links(graph, &partition, class_map);
+    bool *is_transient = find_transient_classes(&partition, &links);
+    int *periods = get_class_periods(graph, &partition, class_map);
+
+    int period = 1;
+    for (int c = 0; c < partition.class_count; c++) {
+        if (is_transient[c] || periods[c] <= 1) continue;
+        long long multiple = (long long) period / gcd(period, periods[c]) * periods[c];
+        if (multiple > limit) {
+            period = 0;
+            break;
         }
+        period = (int) multiple;
     }
-    
-    free_matrix(power_matrix);
-    free_matrix(result_matrix);
+
     free(periods);
-    
-    return result;
-}
\ No newline at end of file
+    free(is_transient);
+    free_link_array(&links);
+    free(class_map);
+    free_partition(&partition);
+    return period;
+}
+
+int get_period(t_matrix sub_matrix) {
+    int size = sub_matrix.size;
+    if (size == 0) return 0;
+
+    int *level = malloc(size * sizeof(int));
+    int *queue = malloc(size * sizeof(int));
+    if (level == NULL || queue == NULL) exit(EXIT_FAILURE);
+
+    for (int i = 0; i < size; i++) {
+        level[i] = -1;
+    }
+
+    // Même parcours en largeur que get_class_periods, sur les cases non nulles : O(n^2)
+    int head = 0, tail = 0, period = 0;
+    level[0] = 0;
+    queue[tail++] = 0;
+
+    while (head < tail) {
+        int u = queue[head++];
+        for (int v = 0; v < size; v++) {
+            if (sub_matrix.data[u][v] <= 0.0f) continue;
+
+            if (level[v] < 0) {
+                level[v] = level[u] + 1;
+                queue[tail++] = v;
+            } else {
+                period = gcd(period, abs(level[u] + 1 - level[v]));
+            }
+        }
+    }
+
+    free(queue);
+    free(level);
+    return period;
+}
@@ -4,12 +4,31 @@
 #include "utils.h"   
 #include "hasse.h"    
 
-// Structure représentant une matrice carrée de nombres flottants
+// Alignement (en octets) du bloc de données et longueur de ligne multiple de MATRIX_ROW_PADDING flottants
+#define MATRIX_ALIGNMENT 64
+#define MATRIX_ROW_PADDING 16
+
+// Structure représentant une matrice carrée de nombres flottants.
+// Les lignes sont rangées dans un seul bloc aligné ; les colonnes de remplissage restent à 0.
 typedef struct s_matrix {
-    float **data;           // Données de la matrice (tableau 2D)
+    float **data;           // Pointeurs vers les lignes du bloc (accès data[i][j])
+    float *values;          // Bloc contigu aligné de size * stride flottants
     int size;               // Taille de la matrice (pour une matrice carrée)
+    int stride;             // Longueur d'une ligne en mémoire (multiple de MATRIX_ROW_PADDING)
 } t_matrix;
 
+// Nombre de tampons de travail de power_matrix_into
+#define MATRIX_WORKSPACE_BUFFERS 3
+
+// Au-delà de cette période (ppcm des classes fermées), find_stationary_matrix itère sur (I + M) / 2
+#define MATRIX_MAX_CESARO_PERIOD 1000
+
+// Tampons de travail préalloués, réutilisables d'un calcul de puissance à l'autre
+typedef struct s_matrix_workspace {
+    t_matrix buffers[MATRIX_WORKSPACE_BUFFERS];     // Matrices de travail
+    int size;                                       // Taille des matrices
+} t_matrix_workspace;
+
 /**
  * @brief Crée une matrice vide (initialisée à 0) de taille size x size.
  * @param size La dimension de la matrice carrée.
@@ -51,6 +70,16 @@ t_matrix create_matrix_from_graph(t_adj_list *graph);
  */
 t_matrix multiply_matrices(t_matrix matrix_A, t_matrix matrix_B);
 
+/**
+ * @brief Multiplie deux matrices carrées (A * B) dans une matrice déjà allouée.
+ * Noyau par blocs (cache) et micro-tuiles en registres, AVX-512 ou AVX2/FMA
+ * selon le processeur, avec une version scalaire de repli.
+ * @param result La matrice résultat, de même taille, distincte de A et B.
+ * @param A Première matrice.
+ * @param B Deuxième matrice.
+ */
+void multiply_matrices_into(t_matrix result_matrix, t_matrix matrix_A, t_matrix matrix_B);
+
 /**
  * @brief Calcule la différence absolue totale entre deux matrices.
  * @param A Première matrice.
@@ -60,21 +89,72 @@ t_matrix multiply_matrices(t_matrix matrix_A, t_matrix matrix_B);
 float diff_matrices(t_matrix matrix_A, t_matrix matrix_B);
 
 /**
- * @brief Calcule la puissance p-ième d'une matrice (M^p).
+ * @brief Alloue les tampons de travail pour des matrices de taille size.
+ * @param size La dimension des matrices.
+ * @return Les tampons alloués.
+ */
+t_matrix_workspace create_matrix_workspace(int size);
+
+/**
+ * @brief Libère les tampons de travail.
+ * @param workspace Pointeur vers les tampons.
+ */
+void free_matrix_workspace(t_matrix_workspace *workspace);
+
+/**
+ * @brief Calcule la puissance p-ième d'une matrice (M^p) par exponentiation rapide.
  * @param M La matrice de base.
  * @param p La puissance.
- * @return Une nouvelle matrice contenant le résultat.
+ * @return Une nouvelle matrice contenant le résultat (matrice nulle si p < 1).
  */
 t_matrix power_matrix(t_matrix matrix, int p);
 
+/**
+ * @brief Calcule M^p dans une matrice fournie, en O(log p) multiplications et sans allocation
+ * lorsque des tampons de travail sont fournis. result peut être la matrice M elle-même.
+ * @param result La matrice résultat, de même taille que M.
+ * @param M La matrice de base.
+ * @param p La puissance (matrice nulle si p < 1).
+ * @param workspace Tampons de travail de même taille, ou NULL pour des tampons temporaires.
+ */
+void power_matrix_into(t_matrix result_matrix, t_matrix matrix, int p, t_matrix_workspace *workspace);
+
 /**
  * @brief Cherche la matrice stationnaire (limite) par itération.
+ * Si la chaîne est périodique (ppcm d des périodes de ses classes fermées, voir get_chain_period),
+ * itère sur la moyenne de Cesàro des puissances sur d pas, qui converge là où M^n oscille ;
+ * au-delà de MATRIX_MAX_CESARO_PERIOD, itère sur la chaîne paresseuse (I + M) / 2, de même limite.
  * @param M La matrice de transition initiale.
  * @param epsilon Le seuil de convergence (différence minimale).
  * @return La matrice limite approximée.
  */
 t_matrix find_stationary_matrix(t_matrix matrix, float epsilon);
 
+/**
+ * @brief Calcule la distribution stationnaire d'une chaîne irréductible par l'élimination
+ * GTH (Grassmann-Taksar-Heyman), en double et sans soustraction : précision complète en une
+ * seule passe O(n^3). Les pivots sont traités par panneaux, et la mise à jour des lignes
+ * restantes est répartie sur le pool de threads.
+ * @param M La matrice de transition.
+ * @return pi (tableau de M.size doubles, à libérer), ou NULL si une ligne sans sortie vers les
+ * états restants apparaît (chaîne non irréductible).
+ */
+double *gth_stationary(t_matrix matrix);
+
+/**
+ * @brief Calcule la matrice limite à partir de la décomposition en classes, sans puissance de la
+ * matrice entière : la distribution stationnaire de chaque classe fermée est calculée seule
+ * (create_sub_matrix puis gth_stationary), et les probabilités d'absorption des états transitoires
+ * par un petit système dense par classe transitoire, dans l'ordre topologique inverse des classes.
+ * L[i][j] = P(absorption dans la classe de j depuis i) * pi_classe(j). C'est la limite de M^n si
+ * les classes fermées sont apériodiques, et la moyenne de Cesàro des M^n sinon.
+ * @param M La matrice de transition.
+ * @param partition Pointeur vers la partition en classes (tarjan ou find_scc).
+ * @param link_array Pointeur vers les liens entre classes (find_class_links).
+ * @return La matrice limite.
+ */
+t_matrix compute_limit_matrix(t_matrix matrix, t_partition *partition, t_link_array *link_array);
+
 /**
  * @brief Extrait une sous-matrice correspondant aux sommets d'une classe donnée.
  * @param matrix La matrice globale du graphe.
@@ -93,10 +173,31 @@ t_matrix create_sub_matrix(t_matrix matrix, t_partition *partition, int class_in
 int gcd(int x, int y);
 
 /**
- * @brief Calcule la période d'une sous-matrice (classe).
+ * @brief Calcule la période d'une sous-matrice (classe) par un parcours en largeur depuis le
+ * premier état : PGCD des level[u] + 1 - level[v] sur les cases non nulles, en O(n^2).
  * @param sub_matrix La sous-matrice de la classe.
- * @return La période (d) de la classe.
+ * @return La période (d) de la classe, 0 si la classe ne contient aucun cycle.
  */
 int get_period(t_matrix sub_matrix);
 
+/**
+ * @brief Calcule la période de chaque classe sur le graphe creux, en O(V + E) au total :
+ * un parcours en largeur par classe, restreint à ses arêtes internes, donne des niveaux,
+ * et la période est le PGCD des level[u] + 1 - level[v] sur ces arêtes.
+ * @param graph Pointeur vers le graphe.
+ * @param partition Pointeur vers la partition (tarjan ou find_scc).
+ * @param class_map Tableau de mappage sommet->classe (create_class_map).
+ * @return Un tableau de périodes (une par classe, à libérer) ; 0 pour une classe sans cycle.
+ */
+int *get_class_periods(t_adj_list *graph, t_partition *partition, int *class_map);
+
+/**
+ * @brief Calcule la période de la chaîne entière : ppcm des périodes de ses classes fermées
+ * (les classes transitoires n'empêchent pas la convergence), en O(V + E).
+ * @param graph Pointeur vers le graphe.
+ * @param limit Période maximale acceptée.
+ * @return La période (1 si apériodique), ou 0 si le ppcm dépasse limit.
+ */
+int get_chain_period(t_adj_list *graph, int limit);
+
 #endif // __MATRIX_H__
\ No newline at end of file
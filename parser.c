@@ -0,0 +1,280 @@
+#include "parser.h"
+#include <errno.h>
+#include <limits.h>
+#include <stdint.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Puissances de 10 représentables exactement en double
+static const double powers_of_ten[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static bool is_blank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+static bool is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+static void set_error(t_parse_error *error, long line, const char *message) {
+    error->line = line;
+    snprintf(error->message, sizeof(error->message), "%s", message);
+}
+
+#ifndef _WIN32
+
+int map_file(const char *filename, t_mapped_file *file) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) return -1;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        return -1;
+    }
+
+    file->size = (size_t) info.st_size;
+    file->is_mapped = false;
+    file->data = "";
+
+    if (file->size > 0) {
+        void *data = mmap(NULL, file->size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            close(fd);
+            return -1;
+        }
+        madvise(data, file->size, MADV_SEQUENTIAL);
+        file->data = data;
+        file->is_mapped = true;
+    }
+
+    close(fd);
+    return 0;
+}
+
+void unmap_file(t_mapped_file *file) {
+    if (file->is_mapped) munmap((void *) file->data, file->size);
+    file->data = NULL;
+    file->size = 0;
+    file->is_mapped = false;
+}
+
+#else
+
+int map_file(const char *filename, t_mapped_file *file) {
+    FILE *stream = fopen(filename, "rb");
+    if (stream == NULL) return -1;
+
+    fseek(stream, 0, SEEK_END);
+    long size = ftell(stream);
+    fseek(stream, 0, SEEK_SET);
+    if (size < 0) {
+        fclose(stream);
+        return -1;
+    }
+
+    char *data = malloc(size > 0 ? size : 1);
+    if (data == NULL || fread(data, 1, size, stream) != (size_t) size) {
+        free(data);
+        fclose(stream);
+        errno = EIO;
+        return -1;
+    }
+
+    fclose(stream);
+    file->data = data;
+    file->size = (size_t) size;
+    file->is_mapped = false;
+    return 0;
+}
+
+void unmap_file(t_mapped_file *file) {
+    free((void *) file->data);
+    file->data = NULL;
+    file->size = 0;
+}
+
+#endif
+
+bool parse_int_token(const char **cursor, const char *end, int *value) {
+    const char *p = *cursor;
+    bool negative = false;
+
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = (*p == '-');
+        p++;
+    }
+    if (p >= end || !is_digit(*p)) return false;
+
+    long long result = 0;
+    while (p < end && is_digit(*p)) {
+        result = result * 10 + (*p - '0');
+        if (result > INT_MAX) return false;
+        p++;
+    }
+
+    *value = (int) (negative ? -result : result);
+    *cursor = p;
+    return true;
+}
+
+bool parse_float_token(const char **cursor, const char *end, float *value) {
+    const char *p = *cursor;
+    bool negative = false;
+    uint64_t mantissa = 0;
+    int exponent = 0;
+    int digit_count = 0;
+
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = (*p == '-');
+        p++;
+    }
+
+    // Partie entière puis décimale : au-delà de 18 chiffres, seuls les exposants comptent
+    while (p < end && is_digit(*p)) {
+        if (mantissa < 100000000000000000ULL) mantissa = mantissa * 10 + (*p - '0');
+        else exponent++;
+        digit_count++;
+        p++;
+    }
+    if (p < end && *p == '.') {
+        p++;
+        while (p < end && is_digit(*p)) {
+            if (mantissa < 100000000000000000ULL) {
+                mantissa = mantissa * 10 + (*p - '0');
+                exponent--;
+            }
+            digit_count++;
+            p++;
+        }
+    }
+    if (digit_count == 0) return false;
+
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        p++;
+        bool negative_exponent = false;
+        if (p < end && (*p == '-' || *p == '+')) {
+            negative_exponent = (*p == '-');
+            p++;
+        }
+        if (p >= end || !is_digit(*p)) return false;
+
+        int explicit_exponent = 0;
+        while (p < end && is_digit(*p)) {
+            if (explicit_exponent < 10000) explicit_exponent = explicit_exponent * 10 + (*p - '0');
+            p++;
+        }
+        exponent += negative_exponent ? -explicit_exponent : explicit_exponent;
+    }
+
+    double result = (double) mantissa;
+    while (exponent > 22) {
+        result *= 1e22;
+        exponent -= 22;
+    }
+    while (exponent < -22) {
+        result /= 1e22;
+        exponent += 22;
+    }
+    if (exponent >= 0) result *= powers_of_ten[exponent];
+    else result /= powers_of_ten[-exponent];
+
+    *value = (float) (negative ? -result : result);
+    *cursor = p;
+    return true;
+}
+
+long count_lines(const char *data, const char *end) {
+    long lines = 0;
+    const char *p = data;
+
+    while (p < end && (p = memchr(p, '\n', end - p)) != NULL) {
+        lines++;
+        p++;
+    }
+    return lines;
+}
+
+// Saute les blancs d'une ligne, puis vérifie que l'on est en fin de ligne
+static const char *finish_line(const char *p, const char *end, long *line, t_parse_error *error) {
+    while (p < end && is_blank(*p)) p++;
+
+    if (p < end && *p != '\n') {
+        set_error(error, *line, "caracteres inattendus en fin de ligne");
+        return NULL;
+    }
+    if (p < end) {
+        (*line)++;
+        p++;
+    }
+    return p;
+}
+
+const char *parse_header(const char *data, const char *end, int *nbvert, long *line, t_parse_error *error) {
+    const char *p = data;
+
+    while (p < end && (is_blank(*p) || *p == '\n')) {
+        if (*p == '\n') (*line)++;
+        p++;
+    }
+
+    if (!parse_int_token(&p, end, nbvert) || *nbvert < 1) {
+        set_error(error, *line, "nombre de sommets invalide");
+        return NULL;
+    }
+
+    return finish_line(p, end, line, error);
+}
+
+int parse_edges(const char *data, const char *end, int nbvert, t_edge_list *edges, long *line, t_parse_error *error) {
+    const char *p = data;
+    int depart, arrivee;
+    float proba;
+
+    while (p < end) {
+        while (p < end && is_blank(*p)) p++;
+        if (p >= end) break;
+        if (*p == '\n') {
+            (*line)++;
+            p++;
+            continue;
+        }
+
+        if (!parse_int_token(&p, end, &depart) || p >= end || !is_blank(*p)) {
+            set_error(error, *line, "sommet de depart invalide");
+            return -1;
+        }
+        while (p < end && is_blank(*p)) p++;
+
+        if (!parse_int_token(&p, end, &arrivee) || p >= end || !is_blank(*p)) {
+            set_error(error, *line, "sommet d'arrivee invalide");
+            return -1;
+        }
+        while (p < end && is_blank(*p)) p++;
+
+        if (!parse_float_token(&p, end, &proba)) {
+            set_error(error, *line, "probabilite invalide");
+            return -1;
+        }
+
+        if (depart < 1 || depart > nbvert || arrivee < 1 || arrivee > nbvert) {
+            set_error(error, *line, "identifiant de sommet hors de l'intervalle [1, nbvert]");
+            return -1;
+        }
+
+        edge_list_add(edges, depart - 1, arrivee - 1, proba);
+
+        p = finish_line(p, end, line, error);
+        if (p == NULL) return -1;
+    }
+
+    return 0;
+}
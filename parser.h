@@ -0,0 +1,84 @@
+#ifndef __PARSER_H__
+#define __PARSER_H__
+
+#include <stddef.h>
+#include "utils.h"
+
+// Fichier projeté en mémoire (mmap), ou lu en entier lorsque mmap n'est pas disponible
+typedef struct s_mapped_file {
+    const char *data;       // Contenu du fichier
+    size_t size;            // Taille du contenu en octets
+    bool is_mapped;         // true si data provient de mmap, false si alloué avec malloc
+} t_mapped_file;
+
+// Description d'une erreur de lecture
+typedef struct s_parse_error {
+    long line;              // Numéro de la ligne fautive (à partir de 1)
+    char message[128];      // Description de l'erreur
+} t_parse_error;
+
+/**
+ * @brief Projette un fichier en mémoire en lecture seule.
+ * @param filename Le chemin du fichier.
+ * @param file Pointeur vers la structure à remplir.
+ * @return 0 en cas de succès, -1 sinon (errno est positionné).
+ */
+int map_file(const char *filename, t_mapped_file *file);
+
+/**
+ * @brief Libère la projection d'un fichier.
+ * @param file Pointeur vers le fichier projeté.
+ */
+void unmap_file(t_mapped_file *file);
+
+/**
+ * @brief Lit un entier décimal (avec signe optionnel) sans passer par la locale.
+ * @param cursor Pointeur vers la position courante, avancée après l'entier.
+ * @param end Fin du tampon.
+ * @param value Pointeur vers le résultat.
+ * @return true si un entier valide a été lu.
+ */
+bool parse_int_token(const char **cursor, const char *end, int *value);
+
+/**
+ * @brief Lit un flottant décimal (ex: "0.25", "1", "2.5e-3") sans passer par la locale.
+ * @param cursor Pointeur vers la position courante, avancée après le nombre.
+ * @param end Fin du tampon.
+ * @param value Pointeur vers le résultat.
+ * @return true si un flottant valide a été lu.
+ */
+bool parse_float_token(const char **cursor, const char *end, float *value);
+
+/**
+ * @brief Lit l'en-tête (nombre de sommets) d'un tampon au format texte.
+ * @param data Début du tampon.
+ * @param end Fin du tampon.
+ * @param nbvert Pointeur vers le nombre de sommets lu.
+ * @param line Pointeur vers le compteur de lignes (mis à jour).
+ * @param error Pointeur vers l'erreur à remplir en cas d'échec.
+ * @return La position juste après la ligne d'en-tête, ou NULL en cas d'erreur.
+ */
+const char *parse_header(const char *data, const char *end, int *nbvert, long *line, t_parse_error *error);
+
+/**
+ * @brief Lit des lignes "depart arrivee proba" et les ajoute au tableau d'arêtes.
+ * Les lignes vides sont ignorées, les sommets sont convertis en index à partir de 0.
+ * @param data Début du tampon (doit commencer en début de ligne).
+ * @param end Fin du tampon.
+ * @param nbvert Le nombre de sommets (pour vérifier les identifiants).
+ * @param edges Pointeur vers le tableau d'arêtes à compléter.
+ * @param line Pointeur vers le compteur de lignes (mis à jour).
+ * @param error Pointeur vers l'erreur à remplir en cas d'échec.
+ * @return 0 en cas de succès, -1 en cas d'erreur.
+ */
+int parse_edges(const char *data, const char *end, int nbvert, t_edge_list *edges, long *line, t_parse_error *error);
+
+/**
+ * @brief Compte les lignes d'un tampon (utilisé pour dimensionner les tableaux d'arêtes).
+ * @param data Début du tampon.
+ * @param end Fin du tampon.
+ * @return Le nombre de caractères '\n' rencontrés.
+ */
+long count_lines(const char *data, const char *end);
+
+#endif // __PARSER_H__
@@ -0,0 +1,330 @@
+#include "passage.h"
+#include "stationary.h"
+#include <math.h>
+
+#define PASSAGE_GTH_LIMIT 2000              // Jusqu'à ce nombre d'états, pi est calculée par GTH
+#define PASSAGE_WORK_VECTORS 8              // Vecteurs de travail de BiCGSTAB
+
+// Coefficient d'une ligne de I - P avant tri
+typedef struct s_entry {
+    int column;
+    double value;
+} t_entry;
+
+static int compare_entries(const void *a, const void *b) {
+    int x = ((const t_entry *) a)->column, y = ((const t_entry *) b)->column;
+    return (x > y) - (x < y);
+}
+
+// Construit I - P en CSR : colonnes croissantes, doublons fusionnés, diagonale toujours présente
+static void build_system(t_passage *passage, t_adj_list *graph) {
+    int length = graph->length;
+    passage->offsets = malloc((length + 1) * sizeof(int));
+    passage->columns = malloc((graph->edge_count + length + 1) * sizeof(int));
+    passage->values = malloc((graph->edge_count + length + 1) * sizeof(double));
+    passage->diagonal = malloc((length > 0 ? length : 1) * sizeof(int));
+    if (passage->offsets == NULL || passage->columns == NULL || passage->values == NULL || passage->diagonal == NULL) exit(EXIT_FAILURE);
+
+    int max_degree = 0;
+    for (int i = 0; i < length; i++) {
+        int degree = graph->offsets[i + 1] - graph->offsets[i];
+        if (degree > max_degree) max_degree = degree;
+    }
+    t_entry *row = malloc((max_degree + 1) * sizeof(t_entry));
+    if (row == NULL) exit(EXIT_FAILURE);
+
+    int count = 0;
+    for (int i = 0; i < length; i++) {
+        // Ligne renormalisée en double : (I - P) 1 = 0 doit tenir au-delà de la précision float
+        double row_sum = 0.0;
+        for (int e = graph->offsets[i]; e < graph->offsets[i + 1]; e++) {
+            row_sum += graph->proba[e];
+        }
+        double scale = row_sum > 0.0 ? 1.0 / row_sum : 0.0;
+
+        int row_length = 0;
+        row[row_length].column = i;
+        row[row_length++].value = 1.0;
+        for (int e = graph->offsets[i]; e < graph->offsets[i + 1]; e++) {
+            row[row_length].column = graph->dest[e];
+            row[row_length++].value = -graph->proba[e] * scale;
+        }
+        qsort(row, row_length, sizeof(t_entry), compare_entries);
+
+        passage->offsets[i] = count;
+        for (int k = 0; k < row_length; k++) {
+            if (count > passage->offsets[i] && passage->columns[count - 1] == row[k].column) {
+                passage->values[count - 1] += row[k].value;
+                continue;
+            }
+            if (row[k].column == i) passage->diagonal[i] = count;
+            passage->columns[count] = row[k].column;
+            passage->values[count++] = row[k].value;
+        }
+    }
+    passage->offsets[length] = count;
+    free(row);
+}
+
+// Factorisation ILU(0) (variante IKJ) : aucun remplissage hors du motif de I - P.
+// I - P est singulière : un pivot quasi nul (en pratique le dernier) est remplacé par le
+// coefficient diagonal d'origine, ce qui ne change que la qualité du préconditionneur.
+static void factorize_ilu0(t_passage *passage) {
+    int length = passage->length;
+    int nonzeros = passage->offsets[length];
+    passage->factor = malloc((nonzeros > 0 ? nonzeros : 1) * sizeof(double));
+    int *position = malloc((length > 0 ? length : 1) * sizeof(int));
+    if (passage->factor == NULL || position == NULL) exit(EXIT_FAILURE);
+    memcpy(passage->factor, passage->values, nonzeros * sizeof(double));
+
+    for (int j = 0; j < length; j++) {
+        position[j] = -1;
+    }
+
+    double *a = passage->factor;
+    for (int i = 0; i < length; i++) {
+        for (int e = passage->offsets[i]; e < passage->offsets[i + 1]; e++) {
+            position[passage->columns[e]] = e;
+        }
+
+        for (int e = passage->offsets[i]; e < passage->diagonal[i]; e++) {
+            int k = passage->columns[e];
+            a[e] /= a[passage->diagonal[k]];
+            for (int f = passage->diagonal[k] + 1; f < passage->offsets[k + 1]; f++) {
+                int target = position[passage->columns[f]];
+                if (target >= 0) a[target] -= a[e] * a[f];
+            }
+        }
+
+        double original = passage->values[passage->diagonal[i]];
+        if (fabs(a[passage->diagonal[i]]) <= 1e-8 * fabs(original)) {
+            a[passage->diagonal[i]] = original != 0.0 ? original : 1.0;
+        }
+
+        for (int e = passage->offsets[i]; e < passage->offsets[i + 1]; e++) {
+            position[passage->columns[e]] = -1;
+        }
+    }
+    free(position);
+}
+
+// y = M^-1 x avec M = L U (descente puis remontée)
+static void apply_preconditioner(const t_passage *passage, const double *x, double *y) {
+    const double *a = passage->factor;
+    for (int i = 0; i < passage->length; i++) {
+        double sum = x[i];
+        for (int e = passage->offsets[i]; e < passage->diagonal[i]; e++) {
+            sum -= a[e] * y[passage->columns[e]];
+        }
+        y[i] = sum;
+    }
+    for (int i = passage->length - 1; i >= 0; i--) {
+        double sum = y[i];
+        for (int e = passage->diagonal[i] + 1; e < passage->offsets[i + 1]; e++) {
+            sum -= a[e] * y[passage->columns[e]];
+        }
+        y[i] = sum / a[passage->diagonal[i]];
+    }
+}
+
+// y = (I - P + 1 pi) x
+static void apply_system(const t_passage *passage, const double *x, double *y) {
+    double projection = 0.0;
+    for (int i = 0; i < passage->length; i++) {
+        projection += passage->stationary[i] * x[i];
+    }
+    for (int i = 0; i < passage->length; i++) {
+        double sum = projection;
+        for (int e = passage->offsets[i]; e < passage->offsets[i + 1]; e++) {
+            sum += passage->values[e] * x[passage->columns[e]];
+        }
+        y[i] = sum;
+    }
+}
+
+static double dot(const double *x, const double *y, int length) {
+    double sum = 0.0;
+    for (int i = 0; i < length; i++) {
+        sum += x[i] * y[i];
+    }
+    return sum;
+}
+
+// Résout (I - P + 1 pi) x = b par BiCGSTAB préconditionné à droite, en partant de x = 0
+static void solve_system(t_passage *passage, const double *b, double *x) {
+    int n = passage->length;
+    double *r = passage->workspace, *r_hat = r + n, *p = r_hat + n, *v = p + n;
+    double *p_hat = v + n, *s = p_hat + n, *s_hat = s + n, *t = s_hat + n;
+
+    for (int i = 0; i < n; i++) {
+        x[i] = 0.0;
+        r[i] = b[i];
+        r_hat[i] = b[i];
+        p[i] = 0.0;
+        v[i] = 0.0;
+    }
+
+    double threshold = PASSAGE_TOLERANCE * sqrt(dot(b, b, n));
+    double rho = 1.0, alpha = 1.0, omega = 1.0;
+    bool converged = sqrt(dot(r, r, n)) <= threshold;
+
+    for (int iteration = 0; iteration < PASSAGE_MAX_ITERATIONS && !converged; iteration++) {
+        passage->iterations++;
+        double rho_next = dot(r_hat, r, n);
+        if (rho_next == 0.0) break;
+
+        double beta = (rho_next / rho) * (alpha / omega);
+        for (int i = 0; i < n; i++) {
+            p[i] = r[i] + beta * (p[i] - omega * v[i]);
+        }
+        apply_preconditioner(passage, p, p_hat);
+        apply_system(passage, p_hat, v);
+        alpha = rho_next / dot(r_hat, v, n);
+
+        for (int i = 0; i < n; i++) {
+            s[i] = r[i] - alpha * v[i];
+        }
+        if (sqrt(dot(s, s, n)) <= threshold) {
+            for (int i = 0; i < n; i++) x[i] += alpha * p_hat[i];
+            converged = true;
+            break;
+        }
+
+        apply_preconditioner(passage, s, s_hat);
+        apply_system(passage, s_hat, t);
+        double tt = dot(t, t, n);
+        omega = tt > 0.0 ? dot(t, s, n) / tt : 0.0;
+
+        for (int i = 0; i < n; i++) {
+            x[i] += alpha * p_hat[i] + omega * s_hat[i];
+            r[i] = s[i] - omega * t[i];
+        }
+        converged = sqrt(dot(r, r, n)) <= threshold;
+        if (omega == 0.0) break;
+        rho = rho_next;
+    }
+
+    if (!converged) passage->converged = false;
+}
+
+t_passage create_passage(t_adj_list *graph) {
+    t_passage passage;
+    passage.length = graph->length;
+    passage.iterations = 0;
+
+    t_stationary stationary = graph->length <= PASSAGE_GTH_LIMIT ? stationary_gth(graph)
+        : stationary_arnoldi(graph, STATIONARY_KRYLOV_DIM, STATIONARY_TOLERANCE, STATIONARY_MAX_ITERATIONS);
+    passage.stationary = stationary.distribution;
+    passage.converged = stationary.converged;
+
+    build_system(&passage, graph);
+    factorize_ilu0(&passage);
+
+    passage.workspace = malloc((size_t) PASSAGE_WORK_VECTORS * (passage.length > 0 ? passage.length : 1) * sizeof(double));
+    if (passage.workspace == NULL) exit(EXIT_FAILURE);
+    return passage;
+}
+
+void passage_times_to(t_passage *passage, int target, double *times) {
+    int n = passage->length;
+    double *b = calloc(n, sizeof(double));
+    if (b == NULL) exit(EXIT_FAILURE);
+    b[target] = 1.0;
+
+    // times reçoit d'abord la colonne target de Z
+    solve_system(passage, b, times);
+    double pi = passage->stationary[target];
+    double z_diagonal = times[target];
+    for (int i = 0; i < n; i++) {
+        times[i] = (z_diagonal - times[i]) / pi;
+    }
+    times[target] = 1.0 / pi;
+    free(b);
+}
+
+void mean_first_passage(t_passage *passage, const int *sources, int source_count, const int *targets, int target_count, double *times) {
+    double *column = malloc(passage->length * sizeof(double));
+    if (column == NULL) exit(EXIT_FAILURE);
+
+    for (int t = 0; t < target_count; t++) {
+        passage_times_to(passage, targets[t], column);
+        for (int s = 0; s < source_count; s++) {
+            times[s * target_count + t] = column[sources[s]];
+        }
+    }
+    free(column);
+}
+
+// Générateur xorshift64 : suite reproductible de signes pour Hutchinson
+static unsigned long long next_random(unsigned long long *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+double kemeny_constant(t_passage *passage, int samples, double *standard_error) {
+    int n = passage->length;
+    double *b = calloc(n > 0 ? n : 1, sizeof(double));
+    double *z = malloc((n > 0 ? n : 1) * sizeof(double));
+    if (b == NULL || z == NULL) exit(EXIT_FAILURE);
+
+    double trace = 0.0, error = 0.0;
+    if (n <= PASSAGE_EXACT_KEMENY) {
+        // Trace exacte : une colonne de Z par état
+        for (int j = 0; j < n; j++) {
+            b[j] = 1.0;
+            solve_system(passage, b, z);
+            trace += z[j];
+            b[j] = 0.0;
+        }
+    } else {
+        unsigned long long state = 0x9E3779B97F4A7C15ULL;
+        double sum = 0.0, sum_squares = 0.0;
+        for (int k = 0; k < samples; k++) {
+            for (int i = 0; i < n; i++) {
+                b[i] = (next_random(&state) >> 63) ? 1.0 : -1.0;
+            }
+            solve_system(passage, b, z);
+            double estimate = dot(b, z, n);
+            sum += estimate;
+            sum_squares += estimate * estimate;
+        }
+        trace = sum / samples;
+        if (samples > 1) {
+            double variance = (sum_squares - samples * trace * trace) / (samples - 1);
+            error = sqrt(variance > 0.0 ? variance / samples : 0.0);
+        }
+    }
+
+    if (standard_error != NULL) *standard_error = error;
+    free(z);
+    free(b);
+    return trace - 1.0;
+}
+
+void display_passage(const t_passage *passage, const double *times, int target, double kemeny, double kemeny_error, int max_states) {
+    printf("%d iteration(s) de BiCGSTAB%s.\n", passage->iterations, passage->converged ? "" : ", sans convergence");
+    printf("Constante de Kemeny : %.6f", kemeny);
+    if (kemeny_error > 0.0) printf(" (estimation, erreur type %.2e)", kemeny_error);
+    printf("\n");
+
+    printf("  Temps moyen de retour en %d : %.4f pas\n", target + 1, times[target]);
+    int shown = 0;
+    for (int i = 0; i < passage->length && shown < max_states; i++) {
+        if (i == target) continue;
+        printf("  Etat %d -> %d : %.4f pas\n", i + 1, target + 1, times[i]);
+        shown++;
+    }
+}
+
+void free_passage(t_passage *passage) {
+    free(passage->stationary);
+    free(passage->offsets);
+    free(passage->columns);
+    free(passage->values);
+    free(passage->diagonal);
+    free(passage->factor);
+    free(passage->workspace);
+    passage->length = 0;
+}
@@ -0,0 +1,86 @@
+#ifndef __PASSAGE_H__
+#define __PASSAGE_H__
+
+#include "utils.h"
+
+#define PASSAGE_TOLERANCE 1e-10             // Seuil par défaut sur le résidu relatif de BiCGSTAB
+#define PASSAGE_MAX_ITERATIONS 10000        // Nombre maximal d'itérations par système
+#define PASSAGE_EXACT_KEMENY 1000           // Jusqu'à ce nombre d'états, la trace de Z est calculée exactement
+#define PASSAGE_KEMENY_SAMPLES 32           // Nombre de vecteurs aléatoires de l'estimateur de Hutchinson
+
+// Temps moyens de premier passage d'une chaîne irréductible, par la matrice fondamentale
+// Z = (I - P + 1 pi)^-1 : m_ij = (z_jj - z_ij) / pi_j et m_jj = 1 / pi_j (temps de retour).
+// Chaque colonne de Z est un système creux résolu par BiCGSTAB, préconditionné par une
+// factorisation ILU(0) de I - P calculée une seule fois.
+typedef struct s_passage {
+    int length;                     // Nombre d'états
+    double *stationary;             // Distribution stationnaire pi
+    int *offsets;                   // I - P en CSR : length + 1 offsets
+    int *columns;                   // Colonnes croissantes de chaque ligne (diagonale comprise)
+    double *values;                 // Coefficients de I - P
+    int *diagonal;                  // Position du terme diagonal de chaque ligne
+    double *factor;                 // ILU(0) : L (diagonale unité) et U rangés sur le motif de I - P
+    double *workspace;              // Vecteurs de travail de BiCGSTAB
+    int iterations;                 // Nombre total d'itérations de BiCGSTAB
+    bool converged;                 // false si pi ou l'un des systèmes n'a pas convergé
+} t_passage;
+
+/**
+ * @brief Prépare le calcul des temps de premier passage : distribution stationnaire (GTH pour
+ * les petites chaînes, Arnoldi sinon), matrice I - P creuse et son préconditionneur ILU(0).
+ * La chaîne doit être irréductible (une seule classe).
+ * @param graph Pointeur vers le graphe.
+ * @return Le contexte (à libérer avec free_passage).
+ */
+t_passage create_passage(t_adj_list *graph);
+
+/**
+ * @brief Calcule les temps moyens de premier passage de tous les états vers un état cible
+ * (une colonne de la matrice des temps de premier passage, un seul système creux).
+ * @param passage Pointeur vers le contexte.
+ * @param target L'état cible (index à partir de 0).
+ * @param times Tableau de length cases : times[i] = m_i,target, times[target] = temps de retour.
+ */
+void passage_times_to(t_passage *passage, int target, double *times);
+
+/**
+ * @brief Calcule un bloc de la matrice des temps de premier passage : lignes sources et colonnes
+ * cibles choisies (un système creux par cible, avec le même préconditionneur).
+ * @param passage Pointeur vers le contexte.
+ * @param sources Les états de départ (index à partir de 0).
+ * @param source_count Nombre d'états de départ.
+ * @param targets Les états cibles (index à partir de 0).
+ * @param target_count Nombre d'états cibles.
+ * @param times Tableau de source_count * target_count cases : times[s * target_count + t].
+ */
+void mean_first_passage(t_passage *passage, const int *sources, int source_count, const int *targets, int target_count, double *times);
+
+/**
+ * @brief Calcule la constante de Kemeny K = somme_j pi_j m_ij (indépendante de i, avec m_ii = 0),
+ * égale à trace(Z) - 1. La trace est exacte jusqu'à PASSAGE_EXACT_KEMENY états, estimée au-delà
+ * par Hutchinson (moyenne de v^T Z v sur des vecteurs v de +-1).
+ * @param passage Pointeur vers le contexte.
+ * @param samples Nombre de vecteurs aléatoires de l'estimation.
+ * @param standard_error Pointeur vers l'erreur type de l'estimation (0 si exacte), ou NULL.
+ * @return La constante de Kemeny.
+ */
+double kemeny_constant(t_passage *passage, int samples, double *standard_error);
+
+/**
+ * @brief Affiche les temps de premier passage vers un état et la constante de Kemeny.
+ * @param passage Pointeur vers le contexte.
+ * @param times Les temps calculés par passage_times_to.
+ * @param target L'état cible (index à partir de 0).
+ * @param kemeny La constante de Kemeny.
+ * @param kemeny_error Son erreur type.
+ * @param max_states Nombre maximal d'états affichés.
+ */
+void display_passage(const t_passage *passage, const double *times, int target, double kemeny, double kemeny_error, int max_states);
+
+/**
+ * @brief Libère le contexte.
+ * @param passage Pointeur vers le contexte.
+ */
+void free_passage(t_passage *passage);
+
+#endif // __PASSAGE_H__
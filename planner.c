@@ -0,0 +1,161 @@
+#include "planner.h"
+#include "matrix.h"
+#include "stationary.h"
+#include <errno.h>
+#include <limits.h>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+static long long memory_budget = 0;
+
+long long default_memory_budget(void) {
+    long long bytes;
+    const char *requested = getenv("MARKOV_MEMORY_BUDGET");
+    if (requested != NULL && parse_memory_size(requested, &bytes)) return bytes;
+
+#ifdef _WIN32
+    long long physical = 4LL << 30;
+#else
+    long long physical = (long long) sysconf(_SC_PHYS_PAGES) * sysconf(_SC_PAGE_SIZE);
+    if (physical <= 0) physical = 4LL << 30;
+#endif
+    return physical / PLANNER_DEFAULT_BUDGET_DIVISOR;
+}
+
+long long get_memory_budget(void) {
+    if (memory_budget <= 0) {
+        memory_budget = default_memory_budget();
+    }
+    return memory_budget;
+}
+
+void set_memory_budget(long long bytes) {
+    memory_budget = bytes;
+}
+
+bool parse_memory_size(const char *text, long long *bytes) {
+    char *end;
+    errno = 0;
+    long long value = strtoll(text, &end, 10);
+    if (end == text || value <= 0 || errno == ERANGE) return false;
+
+    int shift;
+    switch (*end) {
+        case '\0': shift = 0; break;
+        case 'K': case 'k': shift = 10; end++; break;
+        case 'M': case 'm': shift = 20; end++; break;
+        case 'G': case 'g': shift = 30; end++; break;
+        default: return false;
+    }
+    // Taille non représentable sur un long long : refusée avant le décalage
+    if (*end != '\0' || value > LLONG_MAX >> shift) return false;
+
+    *bytes = value << shift;
+    return true;
+}
+
+// Taille d'une t_matrix n x n (lignes complétées à MATRIX_ROW_PADDING floats)
+static long long dense_matrix_bytes(long long n) {
+    return n * ((n + MATRIX_ROW_PADDING - 1) / MATRIX_ROW_PADDING * MATRIX_ROW_PADDING) * (long long) sizeof(float);
+}
+
+// Copie en double de gth_stationary (lignes complétées à 8)
+static long long gth_bytes(long long n) {
+    return n * ((n + 7) / 8 * 8) * (long long) sizeof(double);
+}
+
+// Nombre de coefficients non nuls de P^2 majoré ligne par ligne par n : somme des degrés des successeurs
+static long long square_nonzeros(const t_adj_list *graph) {
+    long long total = 0;
+    for (int i = 0; i < graph->length; i++) {
+        long long row = 0;
+        for (int e = graph->offsets[i]; e < graph->offsets[i + 1] && row < graph->length; e++) {
+            int j = graph->dest[e];
+            row += graph->offsets[j + 1] - graph->offsets[j];
+        }
+        total += row < graph->length ? row : graph->length;
+    }
+    return total;
+}
+
+t_plan plan_analysis(const t_adj_list *graph, t_analysis analysis) {
+    long long n = graph->length;
+    long long edges = graph->edge_count;
+    long long csr_bytes = edges * (long long) (sizeof(int) + sizeof(float)) + (n + 1) * (long long) sizeof(int);
+
+    t_plan plan;
+    plan.analysis = analysis;
+    plan.budget = get_memory_budget();
+
+    switch (analysis) {
+        case ANALYSIS_STATIONARY:
+            // GTH : matrice float + copie double ; creux : transposé + base de Krylov d'Arnoldi
+            plan.dense_bytes = dense_matrix_bytes(n) + gth_bytes(n);
+            plan.sparse_bytes = csr_bytes + (STATIONARY_KRYLOV_DIM + 3) * n * (long long) sizeof(double);
+            break;
+        case ANALYSIS_PERIOD:
+            // Matrice + sous-matrice d'une classe ; creux : niveaux, file et partition
+            plan.dense_bytes = 2 * dense_matrix_bytes(n);
+            plan.sparse_bytes = 5 * n * (long long) sizeof(int);
+            break;
+        case ANALYSIS_POWER:
+            // Matrice, résultat et tampons de l'exponentiation ; creux : au moins P^2 et deux tampons
+            plan.dense_bytes = (2 + MATRIX_WORKSPACE_BUFFERS) * dense_matrix_bytes(n);
+            plan.sparse_bytes = 3 * (square_nonzeros(graph) * (long long) (sizeof(int) + sizeof(float)) + (n + 1) * (long long) sizeof(int));
+            break;
+        case ANALYSIS_LIMIT:
+        default:
+            // Matrice et limite + GTH par classe ; creux : probabilités d'absorption (au moins une par état)
+            plan.dense_bytes = 2 * dense_matrix_bytes(n) + gth_bytes(n);
+            plan.sparse_bytes = csr_bytes + n * (long long) (2 * sizeof(double) + 4 * sizeof(int));
+            break;
+    }
+
+    bool dense_fits = plan.dense_bytes <= plan.budget;
+    bool sparse_fits = plan.sparse_bytes <= plan.budget;
+
+    if (!dense_fits && !sparse_fits) {
+        plan.engine = plan.sparse_bytes <= plan.dense_bytes ? ENGINE_SPARSE : ENGINE_DENSE;
+        plan.reason = "aucun chemin ne tient dans le budget, le moins gourmand est tente";
+    } else if (!dense_fits) {
+        plan.engine = ENGINE_SPARSE;
+        plan.reason = "matrice dense hors budget";
+    } else if (!sparse_fits) {
+        plan.engine = ENGINE_DENSE;
+        plan.reason = "chemin creux hors budget";
+    } else if (analysis == ANALYSIS_PERIOD) {
+        plan.engine = ENGINE_SPARSE;
+        plan.reason = "parcours en largeur creux en O(V + E), jamais plus lent que le dense en O(n^2)";
+    } else if (analysis == ANALYSIS_POWER && edges * 16 >= n * n) {
+        // Graphe dense : le remplissage des produits creux rattrape vite la matrice pleine
+        plan.engine = ENGINE_DENSE;
+        plan.reason = "graphe dense, produits de matrices par blocs SIMD";
+    } else if (n <= PLANNER_DENSE_MAX_STATES) {
+        plan.engine = ENGINE_DENSE;
+        plan.reason = "petite chaine, calcul dense direct";
+    } else {
+        plan.engine = ENGINE_SPARSE;
+        plan.reason = "trop d'etats pour un calcul dense en O(n^3)";
+    }
+    return plan;
+}
+
+static void format_bytes(long long bytes, char *buffer, size_t size) {
+    if (bytes >= 1LL << 30) snprintf(buffer, size, "%.1f Gio", bytes / (double) (1LL << 30));
+    else if (bytes >= 1LL << 20) snprintf(buffer, size, "%.1f Mio", bytes / (double) (1LL << 20));
+    else snprintf(buffer, size, "%.1f Kio", bytes / 1024.0);
+}
+
+void display_plan(const t_plan *plan) {
+    static const char *analysis_names[] = { "stationnaire", "periodes", "puissances", "limite" };
+    char dense[32], sparse[32], budget[32];
+    format_bytes(plan->dense_bytes, dense, sizeof(dense));
+    format_bytes(plan->sparse_bytes, sparse, sizeof(sparse));
+    format_bytes(plan->budget, budget, sizeof(budget));
+
+    printf("Planificateur (%s) : moteur %s (dense %s, creux %s, budget %s) : %s.\n",
+           analysis_names[plan->analysis], plan->engine == ENGINE_DENSE ? "dense" : "creux",
+           dense, sparse, budget, plan->reason);
+}
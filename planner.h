@@ -0,0 +1,78 @@
+#ifndef __PLANNER_H__
+#define __PLANNER_H__
+
+#include "utils.h"
+
+// Au-delà de ce nombre d'états, les noyaux denses en O(n^3) sont écartés même si la mémoire suffit
+#define PLANNER_DENSE_MAX_STATES 4096
+// Budget mémoire par défaut (sans MARKOV_MEMORY_BUDGET) : cette fraction de la mémoire physique
+#define PLANNER_DEFAULT_BUDGET_DIVISOR 2
+
+// Analyse à planifier
+typedef enum e_analysis {
+    ANALYSIS_STATIONARY,            // Distribution stationnaire
+    ANALYSIS_PERIOD,                // Périodes des classes
+    ANALYSIS_POWER,                 // Puissances de la matrice de transition
+    ANALYSIS_LIMIT                  // Matrice limite
+} t_analysis;
+
+// Moteur de calcul choisi
+typedef enum e_engine {
+    ENGINE_DENSE,                   // Noyaux de matrix.c sur la matrice n x n
+    ENGINE_SPARSE                   // Noyaux creux sur le graphe (O(V + E))
+} t_engine;
+
+// Choix du planificateur et estimations mémoire (en octets) des deux chemins
+typedef struct s_plan {
+    t_analysis analysis;            // Analyse planifiée
+    t_engine engine;                // Moteur retenu
+    long long dense_bytes;          // Mémoire estimée du chemin dense
+    long long sparse_bytes;         // Mémoire estimée du chemin creux (hors graphe, déjà chargé)
+    long long budget;               // Budget mémoire appliqué
+    const char *reason;             // Raison du choix (affichée)
+} t_plan;
+
+/**
+ * @brief Donne le budget mémoire par défaut : la variable d'environnement MARKOV_MEMORY_BUDGET
+ * si elle est définie (même syntaxe que parse_memory_size), sinon une fraction de la mémoire physique.
+ * @return Le budget en octets.
+ */
+long long default_memory_budget(void);
+
+/**
+ * @brief Donne le budget mémoire du programme (default_memory_budget au premier appel).
+ * @return Le budget en octets.
+ */
+long long get_memory_budget(void);
+
+/**
+ * @brief Fixe le budget mémoire du programme.
+ * @param bytes Le budget en octets.
+ */
+void set_memory_budget(long long bytes);
+
+/**
+ * @brief Lit une taille mémoire : un entier suivi éventuellement de K, M ou G (puissances de 1024).
+ * @param text Le texte à lire (ex. "512M", "2G").
+ * @param bytes Pointeur vers la taille lue, en octets.
+ * @return true si le texte est une taille valide et non nulle.
+ */
+bool parse_memory_size(const char *text, long long *bytes);
+
+/**
+ * @brief Choisit le moteur d'une analyse d'après le nombre d'états, la densité du graphe et le
+ * budget mémoire : le chemin dense est écarté s'il dépasse le budget ou si la chaîne est trop
+ * grande pour un calcul en O(n^3) ; le chemin creux est préféré dès qu'il est au moins aussi rapide.
+ * @param graph Pointeur vers le graphe.
+ * @param analysis L'analyse à planifier.
+ * @return Le plan retenu.
+ */
+t_plan plan_analysis(const t_adj_list *graph, t_analysis analysis);
+
+/**
+ * @brief Affiche le moteur retenu, les estimations mémoire et la raison du choix.
+ * @param plan Pointeur vers le plan.
+ */
+void display_plan(const t_plan *plan);
+
+#endif // __PLANNER_H__
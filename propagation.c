@@ -0,0 +1,356 @@
+#include "propagation.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define PROPAGATION_X86_SIMD
+#endif
+
+// Contexte partagé d'un produit y = x P
+typedef struct s_propagation_task {
+    const t_propagator *propagator;
+    const double *x;
+    double *y;
+} t_propagation_task;
+
+static void propagation_task(void *context, int block) {
+    t_propagation_task *task = context;
+    const t_adj_list *transpose = &task->propagator->transpose;
+
+    for (int v = task->propagator->block_starts[block]; v < task->propagator->block_starts[block + 1]; v++) {
+        double sum = 0.0;
+        for (int e = transpose->offsets[v]; e < transpose->offsets[v + 1]; e++) {
+            sum += task->x[transpose->dest[e]] * transpose->proba[e];
+        }
+        task->y[v] = sum;
+    }
+}
+
+t_propagator create_propagator(t_adj_list *graph) {
+    t_propagator propagator;
+    propagator.length = graph->length;
+    propagator.transpose = transpose_adjlist(graph);
+    propagator.pool = pool_for_work((long) graph->length + graph->edge_count);
+    propagator.block_count = propagator.pool != NULL ? propagator.pool->thread_count * 4 : 1;
+    propagator.block_starts = balanced_blocks(&propagator.transpose, propagator.block_count);
+    return propagator;
+}
+
+void propagate_step(const t_propagator *propagator, const double *x, double *y) {
+    t_propagation_task task = { .propagator = propagator, .x = x, .y = y };
+    run_parallel(propagator->pool, propagator->block_count, propagation_task, &task);
+}
+
+void free_propagator(t_propagator *propagator) {
+    free(propagator->block_starts);
+    free_adjlist(&propagator->transpose);
+}
+
+t_propagation create_propagation_from(const t_propagator *propagator, const double *initial) {
+    int length = propagator->length > 0 ? propagator->length : 1;
+
+    t_propagation propagation;
+    propagation.propagator = propagator;
+    propagation.current_step = 0;
+    propagation.products = 0;
+    propagation.initial = malloc(length * sizeof(double));
+    propagation.current = malloc(length * sizeof(double));
+    propagation.scratch = malloc(length * sizeof(double));
+    if (propagation.initial == NULL || propagation.current == NULL || propagation.scratch == NULL) exit(EXIT_FAILURE);
+
+    memcpy(propagation.initial, initial, propagator->length * sizeof(double));
+    memcpy(propagation.current, initial, propagator->length * sizeof(double));
+    for (int k = 0; k < PROPAGATION_MAX_CHECKPOINTS; k++) {
+        propagation.checkpoints[k] = NULL;
+    }
+    return propagation;
+}
+
+t_propagation create_propagation(const t_propagator *propagator, int start_state) {
+    double *initial = calloc(propagator->length > 0 ? propagator->length : 1, sizeof(double));
+    if (initial == NULL) exit(EXIT_FAILURE);
+    initial[start_state] = 1.0;
+
+    t_propagation propagation = create_propagation_from(propagator, initial);
+    free(initial);
+    return propagation;
+}
+
+const double *propagate_to(t_propagation *propagation, int steps) {
+    int length = propagation->propagator->length;
+
+    // Point de départ : le plus avancé parmi le pas courant et les points de reprise <= steps
+    int best = -1;
+    for (int k = 0; k < PROPAGATION_MAX_CHECKPOINTS && (1LL << k) <= steps; k++) {
+        if (propagation->checkpoints[k] != NULL) best = k;
+    }
+    if (propagation->current_step > steps || (best >= 0 && (1 << best) > propagation->current_step)) {
+        if (best >= 0) {
+            memcpy(propagation->current, propagation->checkpoints[best], length * sizeof(double));
+            propagation->current_step = 1 << best;
+        } else {
+            memcpy(propagation->current, propagation->initial, length * sizeof(double));
+            propagation->current_step = 0;
+        }
+    }
+
+    while (propagation->current_step < steps) {
+        propagate_step(propagation->propagator, propagation->current, propagation->scratch);
+        double *swap = propagation->current;
+        propagation->current = propagation->scratch;
+        propagation->scratch = swap;
+        propagation->current_step++;
+        propagation->products++;
+
+        // Pas 2^k : copie gardée comme point de reprise
+        int step = propagation->current_step;
+        if ((step & (step - 1)) == 0) {
+            int k = __builtin_ctz(step);
+            if (k < PROPAGATION_MAX_CHECKPOINTS && propagation->checkpoints[k] == NULL) {
+                propagation->checkpoints[k] = malloc(length * sizeof(double));
+                if (propagation->checkpoints[k] == NULL) exit(EXIT_FAILURE);
+                memcpy(propagation->checkpoints[k], propagation->current, length * sizeof(double));
+            }
+        }
+    }
+    return propagation->current;
+}
+
+// Noyau du produit par lot sur les sommets [begin, end) : Y[v] = somme des p(u, v) X[u]
+typedef void (*t_batch_rows)(const t_adj_list *, const double *, double *, int, int, int);
+
+static void batch_rows_scalar(const t_adj_list *transpose, const double *x, double *y, int stride, int begin, int end) {
+    for (int v = begin; v < end; v++) {
+        double *restrict y_row = y + (size_t) v * stride;
+        memset(y_row, 0, stride * sizeof(double));
+        for (int e = transpose->offsets[v]; e < transpose->offsets[v + 1]; e++) {
+            const double *restrict x_row = x + (size_t) transpose->dest[e] * stride;
+            double p = transpose->proba[e];
+            for (int j = 0; j < stride; j++) {
+                y_row[j] += p * x_row[j];
+            }
+        }
+    }
+}
+
+#ifdef PROPAGATION_X86_SIMD
+
+// Tranches de 16 colonnes (4 accumulateurs), puis de 8 ; stride est multiple de 8
+__attribute__((target("avx2,fma")))
+static void batch_rows_avx2(const t_adj_list *transpose, const double *x, double *y, int stride, int begin, int end) {
+    for (int v = begin; v < end; v++) {
+        double *y_row = y + (size_t) v * stride;
+        int e0 = transpose->offsets[v], e1 = transpose->offsets[v + 1];
+        int j = 0;
+
+        for (; j + 16 <= stride; j += 16) {
+            __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+            __m256d acc2 = _mm256_setzero_pd(), acc3 = _mm256_setzero_pd();
+            for (int e = e0; e < e1; e++) {
+                const double *x_row = x + (size_t) transpose->dest[e] * stride + j;
+                __m256d p = _mm256_set1_pd(transpose->proba[e]);
+                acc0 = _mm256_fmadd_pd(p, _mm256_load_pd(x_row), acc0);
+                acc1 = _mm256_fmadd_pd(p, _mm256_load_pd(x_row + 4), acc1);
+                acc2 = _mm256_fmadd_pd(p, _mm256_load_pd(x_row + 8), acc2);
+                acc3 = _mm256_fmadd_pd(p, _mm256_load_pd(x_row + 12), acc3);
+            }
+            _mm256_store_pd(y_row + j, acc0);
+            _mm256_store_pd(y_row + j + 4, acc1);
+            _mm256_store_pd(y_row + j + 8, acc2);
+            _mm256_store_pd(y_row + j + 12, acc3);
+        }
+
+        for (; j < stride; j += 8) {
+            __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+            for (int e = e0; e < e1; e++) {
+                const double *x_row = x + (size_t) transpose->dest[e] * stride + j;
+                __m256d p = _mm256_set1_pd(transpose->proba[e]);
+                acc0 = _mm256_fmadd_pd(p, _mm256_load_pd(x_row), acc0);
+                acc1 = _mm256_fmadd_pd(p, _mm256_load_pd(x_row + 4), acc1);
+            }
+            _mm256_store_pd(y_row + j, acc0);
+            _mm256_store_pd(y_row + j + 4, acc1);
+        }
+    }
+}
+
+// Tranches de 32 colonnes (4 accumulateurs), puis de 8
+__attribute__((target("avx512f")))
+static void batch_rows_avx512(const t_adj_list *transpose, const double *x, double *y, int stride, int begin, int end) {
+    for (int v = begin; v < end; v++) {
+        double *y_row = y + (size_t) v * stride;
+        int e0 = transpose->offsets[v], e1 = transpose->offsets[v + 1];
+        int j = 0;
+
+        for (; j + 32 <= stride; j += 32) {
+            __m512d acc0 = _mm512_setzero_pd(), acc1 = _mm512_setzero_pd();
+            __m512d acc2 = _mm512_setzero_pd(), acc3 = _mm512_setzero_pd();
+            for (int e = e0; e < e1; e++) {
+                const double *x_row = x + (size_t) transpose->dest[e] * stride + j;
+                __m512d p = _mm512_set1_pd(transpose->proba[e]);
+                acc0 = _mm512_fmadd_pd(p, _mm512_load_pd(x_row), acc0);
+                acc1 = _mm512_fmadd_pd(p, _mm512_load_pd(x_row + 8), acc1);
+                acc2 = _mm512_fmadd_pd(p, _mm512_load_pd(x_row + 16), acc2);
+                acc3 = _mm512_fmadd_pd(p, _mm512_load_pd(x_row + 24), acc3);
+            }
+            _mm512_store_pd(y_row + j, acc0);
+            _mm512_store_pd(y_row + j + 8, acc1);
+            _mm512_store_pd(y_row + j + 16, acc2);
+            _mm512_store_pd(y_row + j + 24, acc3);
+        }
+
+        for (; j < stride; j += 8) {
+            __m512d acc = _mm512_setzero_pd();
+            for (int e = e0; e < e1; e++) {
+                __m512d p = _mm512_set1_pd(transpose->proba[e]);
+                acc = _mm512_fmadd_pd(p, _mm512_load_pd(x + (size_t) transpose->dest[e] * stride + j), acc);
+            }
+            _mm512_store_pd(y_row + j, acc);
+        }
+    }
+}
+
+#endif
+
+static t_batch_rows select_batch_rows(void) {
+#ifdef PROPAGATION_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return batch_rows_avx512;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return batch_rows_avx2;
+#endif
+    return batch_rows_scalar;
+}
+
+// Contexte partagé d'un produit par lot Y = X P
+typedef struct s_batch_task {
+    const t_propagator *propagator;
+    const double *x;
+    double *y;
+    int stride;
+    t_batch_rows batch_rows;
+} t_batch_task;
+
+static void batch_task(void *context, int block) {
+    t_batch_task *task = context;
+    task->batch_rows(&task->propagator->transpose, task->x, task->y, task->stride,
+                     task->propagator->block_starts[block], task->propagator->block_starts[block + 1]);
+}
+
+void propagate_batch_step(const t_propagator *propagator, const double *x, double *y, int stride) {
+    static t_batch_rows batch_rows = NULL;
+    if (batch_rows == NULL) batch_rows = select_batch_rows();
+
+    t_batch_task task = { .propagator = propagator, .x = x, .y = y, .stride = stride, .batch_rows = batch_rows };
+    run_parallel(propagator->pool, propagator->block_count, batch_task, &task);
+}
+
+static double *alloc_aligned_doubles(size_t count) {
+    size_t bytes = count * sizeof(double);
+    bytes = (bytes + PROPAGATION_ALIGNMENT - 1) / PROPAGATION_ALIGNMENT * PROPAGATION_ALIGNMENT;
+    if (bytes == 0) bytes = PROPAGATION_ALIGNMENT;
+#ifdef _WIN32
+    double *values = _aligned_malloc(bytes, PROPAGATION_ALIGNMENT);
+#else
+    double *values = aligned_alloc(PROPAGATION_ALIGNMENT, bytes);
+#endif
+    if (values == NULL) exit(EXIT_FAILURE);
+    return values;
+}
+
+static void free_aligned_doubles(double *values) {
+#ifdef _WIN32
+    _aligned_free(values);
+#else
+    free(values);
+#endif
+}
+
+// Lot vide (initial à zéro), colonnes de remplissage comprises
+static t_batch create_empty_batch(const t_propagator *propagator, int count) {
+    t_batch batch;
+    batch.propagator = propagator;
+    batch.count = count;
+    batch.stride = (count + PROPAGATION_BATCH_WIDTH - 1) / PROPAGATION_BATCH_WIDTH * PROPAGATION_BATCH_WIDTH;
+    if (batch.stride == 0) batch.stride = PROPAGATION_BATCH_WIDTH;
+    batch.current_step = 0;
+
+    size_t size = (size_t) propagator->length * batch.stride;
+    batch.initial = alloc_aligned_doubles(size);
+    batch.current = alloc_aligned_doubles(size);
+    batch.scratch = alloc_aligned_doubles(size);
+    memset(batch.initial, 0, size * sizeof(double));
+    return batch;
+}
+
+t_batch create_batch(const t_propagator *propagator, const int *start_states, int count) {
+    t_batch batch = create_empty_batch(propagator, count);
+    for (int c = 0; c < count; c++) {
+        batch.initial[(size_t) start_states[c] * batch.stride + c] = 1.0;
+    }
+    memcpy(batch.current, batch.initial, (size_t) propagator->length * batch.stride * sizeof(double));
+    return batch;
+}
+
+t_batch create_batch_from(const t_propagator *propagator, const double *initial, int count) {
+    t_batch batch = create_empty_batch(propagator, count);
+    for (int c = 0; c < count; c++) {
+        for (int i = 0; i < propagator->length; i++) {
+            batch.initial[(size_t) i * batch.stride + c] = initial[(size_t) c * propagator->length + i];
+        }
+    }
+    memcpy(batch.current, batch.initial, (size_t) propagator->length * batch.stride * sizeof(double));
+    return batch;
+}
+
+void propagate_batch_to(t_batch *batch, int steps) {
+    if (batch->current_step > steps) {
+        memcpy(batch->current, batch->initial, (size_t) batch->propagator->length * batch->stride * sizeof(double));
+        batch->current_step = 0;
+    }
+
+    while (batch->current_step < steps) {
+        propagate_batch_step(batch->propagator, batch->current, batch->scratch, batch->stride);
+        double *swap = batch->current;
+        batch->current = batch->scratch;
+        batch->scratch = swap;
+        batch->current_step++;
+    }
+}
+
+void get_batch_distribution(const t_batch *batch, int column, double *distribution) {
+    for (int i = 0; i < batch->propagator->length; i++) {
+        distribution[i] = batch->current[(size_t) i * batch->stride + column];
+    }
+}
+
+void free_batch(t_batch *batch) {
+    free_aligned_doubles(batch->initial);
+    free_aligned_doubles(batch->current);
+    free_aligned_doubles(batch->scratch);
+}
+
+void display_distribution(const double *distribution, int length, int max_states) {
+    int shown = 0, support = 0;
+    double mass = 0.0;
+    for (int i = 0; i < length; i++) {
+        if (distribution[i] == 0.0) continue;
+        support++;
+        mass += distribution[i];
+        if (shown < max_states) {
+            printf("  Etat %d : %.6f\n", i + 1, distribution[i]);
+            shown++;
+        }
+    }
+    if (shown < support) {
+        printf("  ... (%d etats de probabilite non nulle)\n", support);
+    }
+    printf("  Masse totale : %.6f\n", mass);
+}
+
+void free_propagation(t_propagation *propagation) {
+    for (int k = 0; k < PROPAGATION_MAX_CHECKPOINTS; k++) {
+        free(propagation->checkpoints[k]);
+    }
+    free(propagation->initial);
+    free(propagation->current);
+    free(propagation->scratch);
+}
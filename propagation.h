@@ -0,0 +1,155 @@
+#ifndef __PROPAGATION_H__
+#define __PROPAGATION_H__
+
+#include "utils.h"
+#include "threads.h"
+
+#define PROPAGATION_MAX_CHECKPOINTS 31      // Points de reprise aux pas 1, 2, 4, ..., 2^30
+#define PROPAGATION_BATCH_WIDTH 8           // Largeur des lignes d'un lot arrondie à 8 doubles (64 octets)
+#define PROPAGATION_ALIGNMENT 64            // Alignement des tableaux d'un lot (octets)
+
+// Opérateur x -> x P sur le graphe transposé, préparé une fois par graphe et partagé par les requêtes
+typedef struct s_propagator {
+    int length;                     // Nombre d'états
+    t_adj_list transpose;           // Graphe transposé : arêtes entrantes de chaque état
+    t_thread_pool *pool;            // Pool utilisé (NULL si séquentiel)
+    int block_count;                // Nombre de blocs de sommets
+    int *block_starts;              // Premier sommet de chaque bloc (block_count + 1 cases)
+} t_propagator;
+
+// Requête « distribution après n pas » depuis une distribution initiale, avec points de reprise :
+// les distributions aux pas 2^k déjà calculés sont gardées, et une requête repart du plus proche
+// point connu (pas courant ou point de reprise) qui ne la dépasse pas.
+typedef struct s_propagation {
+    const t_propagator *propagator; // Opérateur partagé
+    double *initial;                // Distribution au pas 0
+    double *current;                // Distribution au pas current_step
+    int current_step;               // Pas de current
+    double *checkpoints[PROPAGATION_MAX_CHECKPOINTS]; // checkpoints[k] : distribution au pas 2^k (ou NULL)
+    double *scratch;                // Tampon du produit
+    long long products;             // Nombre total de produits x P effectués
+} t_propagation;
+
+// Lot de k distributions propagées ensemble : X est stocké état par état (length lignes de stride
+// doubles, la colonne c étant la distribution c), si bien que chaque arête lue fait avancer les k
+// distributions d'un coup sur une ligne contiguë, vectorisée.
+typedef struct s_batch {
+    const t_propagator *propagator; // Opérateur partagé
+    int count;                      // Nombre de distributions k
+    int stride;                     // Longueur d'une ligne (k arrondi à PROPAGATION_BATCH_WIDTH)
+    double *initial;                // Lot au pas 0 (length x stride)
+    double *current;                // Lot au pas current_step (length x stride)
+    double *scratch;                // Tampon du produit
+    int current_step;               // Pas de current
+} t_batch;
+
+/**
+ * @brief Prépare l'opérateur x -> x P : graphe transposé et blocs de travail équilibré.
+ * @param graph Pointeur vers le graphe.
+ * @return L'opérateur (à libérer avec free_propagator).
+ */
+t_propagator create_propagator(t_adj_list *graph);
+
+/**
+ * @brief Calcule y = x P (un produit creux vecteur-matrice, O(V + E)).
+ * @param propagator Pointeur vers l'opérateur.
+ * @param x Distribution de départ (length cases).
+ * @param y Distribution après un pas (length cases, distinct de x).
+ */
+void propagate_step(const t_propagator *propagator, const double *x, double *y);
+
+/**
+ * @brief Libère l'opérateur.
+ * @param propagator Pointeur vers l'opérateur.
+ */
+void free_propagator(t_propagator *propagator);
+
+/**
+ * @brief Crée une requête partant d'un état (distribution concentrée sur start_state).
+ * @param propagator Pointeur vers l'opérateur (doit survivre à la requête).
+ * @param start_state L'état de départ (index à partir de 0).
+ * @return La requête (à libérer avec free_propagation).
+ */
+t_propagation create_propagation(const t_propagator *propagator, int start_state);
+
+/**
+ * @brief Crée une requête partant d'une distribution quelconque.
+ * @param propagator Pointeur vers l'opérateur (doit survivre à la requête).
+ * @param initial La distribution initiale (length cases, copiée).
+ * @return La requête (à libérer avec free_propagation).
+ */
+t_propagation create_propagation_from(const t_propagator *propagator, const double *initial);
+
+/**
+ * @brief Donne la distribution après steps pas : O(steps * (V + E)) depuis le départ, moins si un
+ * point de reprise ou le pas courant est plus proche. Les points 2^k traversés sont mis en cache.
+ * @param propagation Pointeur vers la requête.
+ * @param steps Le nombre de pas (>= 0).
+ * @return La distribution (length cases), valide jusqu'à la requête suivante.
+ */
+const double *propagate_to(t_propagation *propagation, int steps);
+
+/**
+ * @brief Affiche les états de probabilité non nulle d'une distribution.
+ * @param distribution La distribution.
+ * @param length Nombre d'états.
+ * @param max_states Nombre maximal d'états affichés.
+ */
+void display_distribution(const double *distribution, int length, int max_states);
+
+/**
+ * @brief Libère la requête et ses points de reprise.
+ * @param propagation Pointeur vers la requête.
+ */
+void free_propagation(t_propagation *propagation);
+
+/**
+ * @brief Calcule Y = X P pour un lot : un seul passage sur les arêtes pour les k distributions
+ * (produit creux matrice-matrice, noyau AVX2/AVX-512 choisi à l'exécution).
+ * @param propagator Pointeur vers l'opérateur.
+ * @param x Le lot de départ (length x stride, aligné sur PROPAGATION_ALIGNMENT).
+ * @param y Le lot après un pas (même format, distinct de x).
+ * @param stride Longueur d'une ligne (multiple de PROPAGATION_BATCH_WIDTH).
+ */
+void propagate_batch_step(const t_propagator *propagator, const double *x, double *y, int stride);
+
+/**
+ * @brief Crée un lot de count distributions, la distribution c étant concentrée sur start_states[c].
+ * @param propagator Pointeur vers l'opérateur (doit survivre au lot).
+ * @param start_states Les états de départ (index à partir de 0).
+ * @param count Nombre de distributions.
+ * @return Le lot (à libérer avec free_batch).
+ */
+t_batch create_batch(const t_propagator *propagator, const int *start_states, int count);
+
+/**
+ * @brief Crée un lot à partir de distributions quelconques.
+ * @param propagator Pointeur vers l'opérateur (doit survivre au lot).
+ * @param initial Les distributions, à la suite (count x length, copiées).
+ * @param count Nombre de distributions.
+ * @return Le lot (à libérer avec free_batch).
+ */
+t_batch create_batch_from(const t_propagator *propagator, const double *initial, int count);
+
+/**
+ * @brief Avance le lot jusqu'au pas steps (repart du pas 0 si steps est antérieur au pas courant).
+ * @param batch Pointeur vers le lot.
+ * @param steps Le nombre de pas (>= 0).
+ */
+void propagate_batch_to(t_batch *batch, int steps);
+
+/**
+ * @brief Copie une distribution du lot au pas courant.
+ * @param batch Pointeur vers le lot.
+ * @param column Index de la distribution (0 à count - 1).
+ * @param distribution Tableau de length cases à remplir.
+ */
+void get_batch_distribution(const t_batch *batch, int column, double *distribution);
+
+/**
+ * @brief Libère le lot.
+ * @param batch Pointeur vers le lot.
+ */
+void free_batch(t_batch *batch);
+
+#endif // __PROPAGATION_H__
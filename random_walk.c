@@ -0,0 +1,308 @@
+#include "random_walk.h"
+#include "threads.h"
+#include <math.h>
+#include <time.h>
+
+// Constantes de Philox4x32 (Salmon et al., 2011)
+#define PHILOX_M0 0xD2511F53u
+#define PHILOX_M1 0xCD9E8D57u
+#define PHILOX_W0 0x9E3779B9u
+#define PHILOX_W1 0xBB67AE85u
+#define PHILOX_ROUNDS 10
+
+// Nombre de marches avancées ensemble par une tâche
+#define RANDOM_WALK_LANES 8
+
+// Philox4x32-10 : 4 mots aléatoires de 32 bits pour un compteur de 128 bits et une clé de 64 bits
+static inline void philox4x32(uint32_t counter[4], uint32_t key0, uint32_t key1) {
+    for (int round = 0; round < PHILOX_ROUNDS; round++) {
+        uint64_t product0 = (uint64_t) PHILOX_M0 * counter[0];
+        uint64_t product1 = (uint64_t) PHILOX_M1 * counter[2];
+        uint32_t next0 = (uint32_t) (product1 >> 32) ^ counter[1] ^ key0;
+        uint32_t next2 = (uint32_t) (product0 >> 32) ^ counter[3] ^ key1;
+        counter[1] = (uint32_t) product1;
+        counter[3] = (uint32_t) product0;
+        counter[0] = next0;
+        counter[2] = next2;
+        key0 += PHILOX_W0;
+        key1 += PHILOX_W1;
+    }
+}
+
+// Contexte partagé de la construction des tables
+typedef struct s_alias_task {
+    const t_adj_list *graph;
+    t_alias_table *table;
+    const int *block_starts;
+} t_alias_task;
+
+// Construction de Vose pour les états d'un bloc : les cases de poids < 1 (petites) sont complétées
+// par une case de poids > 1 (grande), dont le reste repart dans l'une des deux listes
+static void alias_task(void *context, int block) {
+    t_alias_task *task = context;
+    const t_adj_list *graph = task->graph;
+    int capacity = 0;
+    double *weights = NULL;
+    int *small = NULL, *large = NULL;
+
+    for (int i = task->block_starts[block]; i < task->block_starts[block + 1]; i++) {
+        int first = graph->offsets[i];
+        int degree = graph->offsets[i + 1] - first;
+        if (degree == 0) continue;
+        if (degree > capacity) {
+            capacity = degree;
+            weights = realloc(weights, capacity * sizeof(double));
+            small = realloc(small, capacity * sizeof(int));
+            large = realloc(large, capacity * sizeof(int));
+            if (weights == NULL || small == NULL || large == NULL) exit(EXIT_FAILURE);
+        }
+
+        // Poids ramenés à une moyenne de 1, la ligne étant renormalisée en double
+        double sum = 0.0;
+        for (int k = 0; k < degree; k++) {
+            sum += graph->proba[first + k];
+        }
+        int small_count = 0, large_count = 0;
+        for (int k = 0; k < degree; k++) {
+            weights[k] = sum > 0.0 ? graph->proba[first + k] * degree / sum : 1.0;
+            if (weights[k] < 1.0) small[small_count++] = k;
+            else large[large_count++] = k;
+        }
+
+        while (small_count > 0 && large_count > 0) {
+            int s = small[--small_count];
+            int l = large[large_count - 1];
+            task->table->threshold[first + s] = (uint32_t) (weights[s] * 4294967296.0);
+            task->table->alias[first + s] = graph->dest[first + l];
+            weights[l] -= 1.0 - weights[s];
+            if (weights[l] < 1.0) {
+                large_count--;
+                small[small_count++] = l;
+            }
+        }
+
+        // Cases restantes (poids 1 aux arrondis près) : toujours acceptées
+        while (large_count > 0) {
+            int l = large[--large_count];
+            task->table->threshold[first + l] = UINT32_MAX;
+            task->table->alias[first + l] = graph->dest[first + l];
+        }
+        while (small_count > 0) {
+            int s = small[--small_count];
+            task->table->threshold[first + s] = UINT32_MAX;
+            task->table->alias[first + s] = graph->dest[first + s];
+        }
+    }
+
+    free(weights);
+    free(small);
+    free(large);
+}
+
+t_alias_table create_alias_table(const t_adj_list *graph) {
+    t_alias_table table;
+    table.graph = graph;
+    table.threshold = malloc((graph->edge_count > 0 ? graph->edge_count : 1) * sizeof(uint32_t));
+    table.alias = malloc((graph->edge_count > 0 ? graph->edge_count : 1) * sizeof(int));
+    if (table.threshold == NULL || table.alias == NULL) exit(EXIT_FAILURE);
+
+    t_thread_pool *pool = pool_for_work((long) graph->length + graph->edge_count);
+    int block_count = pool != NULL ? pool->thread_count * 4 : 1;
+    int *block_starts = balanced_blocks(graph, block_count);
+
+    t_alias_task task = { .graph = graph, .table = &table, .block_starts = block_starts };
+    run_parallel(pool, block_count, alias_task, &task);
+
+    free(block_starts);
+    return table;
+}
+
+void free_alias_table(t_alias_table *table) {
+    free(table->threshold);
+    free(table->alias);
+}
+
+// Contexte partagé de la simulation ; chaque bloc cumule ses propres visites et temps d'atteinte
+typedef struct s_walk_task {
+    const t_alias_table *table;
+    int start_state;
+    long long walk_count;
+    int steps;
+    int target;
+    uint32_t key0, key1;
+    int block_count;
+    long long **visits;             // Visites de chaque bloc
+    long long *hit_counts;          // Marches ayant atteint la cible, par bloc
+    double *hit_sums;               // Somme des temps d'atteinte, par bloc
+    double *hit_squares;            // Somme de leurs carrés, par bloc
+} t_walk_task;
+
+static void walk_task(void *context, int block) {
+    t_walk_task *task = context;
+    const t_adj_list *graph = task->table->graph;
+    const uint32_t *threshold = task->table->threshold;
+    const int *alias = task->table->alias;
+
+    long long *visits = calloc(graph->length > 0 ? graph->length : 1, sizeof(long long));
+    if (visits == NULL) exit(EXIT_FAILURE);
+    long long hit_count = 0;
+    double hit_sum = 0.0, hit_square = 0.0;
+
+    long long first_walk = task->walk_count * block / task->block_count;
+    long long last_walk = task->walk_count * (block + 1) / task->block_count;
+
+    // Les marches avancent par groupes de RANDOM_WALK_LANES, pas à pas : les défauts de cache
+    // des marches d'un groupe sont indépendants et se recouvrent au lieu de s'enchaîner
+    for (long long group = first_walk; group < last_walk; group += RANDOM_WALK_LANES) {
+        int lanes = last_walk - group < RANDOM_WALK_LANES ? (int) (last_walk - group) : RANDOM_WALK_LANES;
+        int states[RANDOM_WALK_LANES], hitting_times[RANDOM_WALK_LANES];
+        uint32_t random[RANDOM_WALK_LANES][4];
+        for (int l = 0; l < lanes; l++) {
+            states[l] = task->start_state;
+            hitting_times[l] = 0;
+        }
+
+        for (int t = 0; t < task->steps; t++) {
+            for (int l = 0; l < lanes; l++) {
+                // Un appel à Philox fournit les tirages de 2 pas de la marche group + l
+                if ((t & 1) == 0) {
+                    uint64_t w = (uint64_t) (group + l);
+                    random[l][0] = (uint32_t) (t >> 1);
+                    random[l][1] = 0;
+                    random[l][2] = (uint32_t) w;
+                    random[l][3] = (uint32_t) (w >> 32);
+                    philox4x32(random[l], task->key0, task->key1);
+                }
+
+                // Un mot choisit la case (32 bits hauts de u * degré), un second mot indépendant sert
+                // de fraction : les bits bas de u * degré ne sont pas uniformes pour un grand degré
+                int state = states[l];
+                int first = graph->offsets[state];
+                uint32_t degree = (uint32_t) (graph->offsets[state + 1] - first);
+                if (degree > 0) {
+                    const uint32_t *words = &random[l][2 * (t & 1)];
+                    int slot = first + (int) (((uint64_t) words[0] * degree) >> 32);
+                    state = words[1] < threshold[slot] ? graph->dest[slot] : alias[slot];
+                }
+
+                states[l] = state;
+                visits[state]++;
+                if (state == task->target && hitting_times[l] == 0) {
+                    hitting_times[l] = t + 1;
+                }
+            }
+        }
+
+        for (int l = 0; l < lanes; l++) {
+            if (hitting_times[l] > 0) {
+                hit_count++;
+                hit_sum += hitting_times[l];
+                hit_square += (double) hitting_times[l] * hitting_times[l];
+            }
+        }
+    }
+
+    task->visits[block] = visits;
+    task->hit_counts[block] = hit_count;
+    task->hit_sums[block] = hit_sum;
+    task->hit_squares[block] = hit_square;
+}
+
+static double elapsed_seconds(const struct timespec *start) {
+    struct timespec now;
+    timespec_get(&now, TIME_UTC);
+    return (double) (now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) * 1e-9;
+}
+
+t_walk_result random_walk(const t_alias_table *table, int start_state, long long walk_count, int steps, int target, uint64_t seed) {
+    int length = table->graph->length;
+    struct timespec start;
+    timespec_get(&start, TIME_UTC);
+
+    // Une tâche par thread : les marches ont toutes le même coût
+    t_thread_pool *pool = pool_for_work((long) (walk_count * steps));
+    int block_count = pool != NULL ? pool->thread_count : 1;
+    if (walk_count < block_count) block_count = walk_count > 0 ? (int) walk_count : 1;
+
+    t_walk_task task = {
+        .table = table, .start_state = start_state, .walk_count = walk_count, .steps = steps,
+        .target = target, .key0 = (uint32_t) seed, .key1 = (uint32_t) (seed >> 32), .block_count = block_count
+    };
+    task.visits = malloc(block_count * sizeof(long long *));
+    task.hit_counts = malloc(block_count * sizeof(long long));
+    task.hit_sums = malloc(block_count * sizeof(double));
+    task.hit_squares = malloc(block_count * sizeof(double));
+    if (task.visits == NULL || task.hit_counts == NULL || task.hit_sums == NULL || task.hit_squares == NULL) exit(EXIT_FAILURE);
+
+    run_parallel(pool, block_count, walk_task, &task);
+
+    t_walk_result result;
+    result.length = length;
+    result.walk_count = walk_count;
+    result.steps = steps;
+    result.target = target;
+    result.visits = task.visits[0];
+    result.hit_count = task.hit_counts[0];
+    double hit_sum = task.hit_sums[0], hit_square = task.hit_squares[0];
+    for (int b = 1; b < block_count; b++) {
+        for (int i = 0; i < length; i++) {
+            result.visits[i] += task.visits[b][i];
+        }
+        free(task.visits[b]);
+        result.hit_count += task.hit_counts[b];
+        hit_sum += task.hit_sums[b];
+        hit_square += task.hit_squares[b];
+    }
+
+    result.hitting_time_mean = 0.0;
+    result.hitting_time_error = 0.0;
+    if (result.hit_count > 0) {
+        result.hitting_time_mean = hit_sum / result.hit_count;
+        double variance = hit_square / result.hit_count - result.hitting_time_mean * result.hitting_time_mean;
+        result.hitting_time_error = result.hit_count > 1 && variance > 0.0 ? sqrt(variance / (result.hit_count - 1)) : 0.0;
+    }
+
+    free(task.visits);
+    free(task.hit_counts);
+    free(task.hit_sums);
+    free(task.hit_squares);
+    result.seconds = elapsed_seconds(&start);
+    return result;
+}
+
+void display_walk_result(const t_walk_result *result, int max_states) {
+    long long total_steps = result->walk_count * result->steps;
+    printf("%lld marches de %d pas : %lld pas en %.3f s (%.1f millions de pas/s).\n",
+           result->walk_count, result->steps, total_steps, result->seconds,
+           result->seconds > 0.0 ? total_steps / result->seconds * 1e-6 : 0.0);
+
+    // États les plus visités, par sélection successive du maximum restant
+    int shown = result->length < max_states ? result->length : max_states;
+    long long previous = -1;
+    int previous_state = -1;
+    printf("Frequences de visite (etats les plus visites) :\n");
+    for (int s = 0; s < shown; s++) {
+        int best = -1;
+        for (int i = 0; i < result->length; i++) {
+            long long v = result->visits[i];
+            bool after_previous = previous < 0 || v < previous || (v == previous && i > previous_state);
+            if (after_previous && (best < 0 || v > result->visits[best])) best = i;
+        }
+        if (best < 0 || result->visits[best] == 0) break;
+        printf("  Etat %d : %.6f\n", best + 1, total_steps > 0 ? result->visits[best] / (double) total_steps : 0.0);
+        previous = result->visits[best];
+        previous_state = best;
+    }
+
+    if (result->target >= 0) {
+        printf("Etat %d atteint par %lld marches sur %lld", result->target + 1, result->hit_count, result->walk_count);
+        if (result->hit_count > 0) {
+            printf(" : temps moyen d'atteinte %.4f (erreur type %.4f)", result->hitting_time_mean, result->hitting_time_error);
+        }
+        printf(".\n");
+    }
+}
+
+void free_walk_result(t_walk_result *result) {
+    free(result->visits);
+}
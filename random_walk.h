@@ -0,0 +1,74 @@
+#ifndef __RANDOM_WALK_H__
+#define __RANDOM_WALK_H__
+
+#include <stdint.h>
+#include "utils.h"
+
+#define RANDOM_WALK_DEFAULT_WALKS 1000      // Nombre de marches par défaut
+#define RANDOM_WALK_DEFAULT_STEPS 10000     // Longueur d'une marche par défaut
+#define RANDOM_WALK_DEFAULT_SEED 42         // Graine par défaut
+
+// Tables d'alias de Walker (construction de Vose) : une case par arête. Pour tirer le successeur
+// de i, on choisit une case e de la ligne i uniformément, puis dest[e] si la fraction tirée est
+// sous threshold[e], alias[e] sinon : O(1) par pas quel que soit le degré.
+typedef struct s_alias_table {
+    const t_adj_list *graph;        // Graphe (offsets et dest partagés, doit survivre à la table)
+    uint32_t *threshold;            // Seuil de chaque case, sur 2^32
+    int *alias;                     // État tiré quand la case est rejetée
+} t_alias_table;
+
+// Résultat d'une simulation de Monte-Carlo
+typedef struct s_walk_result {
+    int length;                     // Nombre d'états
+    long long walk_count;           // Nombre de marches
+    int steps;                      // Nombre de pas de chaque marche
+    long long *visits;              // Visites de chaque état aux pas 1 à steps
+    int target;                     // État cible des temps d'atteinte (-1 : aucun)
+    long long hit_count;            // Marches ayant atteint la cible
+    double hitting_time_mean;       // Temps moyen d'atteinte (pas >= 1) des marches l'ayant atteinte
+    double hitting_time_error;      // Erreur type de cette moyenne
+    double seconds;                 // Durée de la simulation
+} t_walk_result;
+
+/**
+ * @brief Construit les tables d'alias de tous les états (O(V + E), en parallèle par blocs).
+ * @param graph Pointeur vers le graphe.
+ * @return Les tables (à libérer avec free_alias_table).
+ */
+t_alias_table create_alias_table(const t_adj_list *graph);
+
+/**
+ * @brief Libère les tables d'alias.
+ * @param table Pointeur vers les tables.
+ */
+void free_alias_table(t_alias_table *table);
+
+/**
+ * @brief Simule walk_count marches de steps pas depuis start_state, réparties sur le pool de threads.
+ * Les nombres aléatoires viennent de Philox4x32-10, un générateur à compteur : la marche w utilise
+ * les compteurs (bloc de pas, w) sous la clé seed, si bien que le résultat ne dépend pas du
+ * nombre de threads.
+ * @param table Pointeur vers les tables d'alias.
+ * @param start_state L'état de départ (index à partir de 0).
+ * @param walk_count Nombre de marches.
+ * @param steps Nombre de pas de chaque marche.
+ * @param target L'état dont on mesure le temps d'atteinte (-1 : aucun).
+ * @param seed La graine.
+ * @return Le résultat (à libérer avec free_walk_result).
+ */
+t_walk_result random_walk(const t_alias_table *table, int start_state, long long walk_count, int steps, int target, uint64_t seed);
+
+/**
+ * @brief Affiche le débit, les fréquences de visite des états les plus visités et le temps d'atteinte.
+ * @param result Pointeur vers le résultat.
+ * @param max_states Nombre maximal d'états affichés.
+ */
+void display_walk_result(const t_walk_result *result, int max_states);
+
+/**
+ * @brief Libère le résultat.
+ * @param result Pointeur vers le résultat.
+ */
+void free_walk_result(t_walk_result *result);
+
+#endif // __RANDOM_WALK_H__
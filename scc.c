@@ -0,0 +1,422 @@
+#include "scc.h"
+#include "threads.h"
+#include <stdatomic.h>
+
+#ifndef SCC_SEQUENTIAL_CUTOFF
+#define SCC_SEQUENTIAL_CUTOFF 4096      // En dessous de ce nombre de sommets actifs, Tarjan termine
+#endif
+#define SCC_BLOCK_SIZE 1024             // Taille minimale d'un bloc de travail parallèle
+#define SCC_MAX_TRIM_ROUNDS 16          // Nombre maximal de tours d'élagage
+
+#define MARK_FORWARD 1
+#define MARK_BACKWARD 2
+
+// État partagé de l'algorithme parallèle
+typedef struct s_scc_state {
+    t_adj_list *graph;              // Graphe
+    t_adj_list reverse;             // Graphe transposé
+    atomic_int *component;          // Représentant de la classe du sommet, -1 si le sommet est actif
+    atomic_int *color;              // Marques avant/arrière, puis couleurs
+    atomic_int *queued;             // Dernier tour où le sommet a été ajouté à une frontière
+    int *active;                    // Sommets actifs
+    int active_count;               // Nombre de sommets actifs
+    t_thread_pool *pool;            // Pool utilisé (NULL si séquentiel)
+    atomic_int trimmed;             // Nombre de sommets élagués au tour courant
+} t_scc_state;
+
+// Balayage parallèle d'une liste de sommets, découpée en blocs
+typedef struct s_sweep {
+    t_scc_state *state;
+    const int *items;               // Sommets à traiter
+    int item_count;                 // Nombre de sommets
+    int task_count;                 // Nombre de blocs
+    t_stack *outputs;               // Une sortie par bloc (frontière suivante)
+    const t_adj_list *graph;        // Graphe parcouru (direct ou transposé)
+    int value;                      // Marque ou numéro de tour
+} t_sweep;
+
+bool parse_scc_engine(const char *name, t_scc_engine *engine) {
+    if (strcmp(name, "tarjan") == 0) *engine = SCC_TARJAN;
+    else if (strcmp(name, "parallel") == 0) *engine = SCC_PARALLEL;
+    else return false;
+    return true;
+}
+
+t_partition find_scc(t_adj_list *graph, t_scc_engine engine) {
+    if (engine == SCC_PARALLEL) return parallel_scc(graph);
+    // tarjan() rend les classes dans l'ordre topologique inverse : même ordre canonique que le moteur parallèle
+    t_partition partition = tarjan(graph);
+    sort_partition(&partition);
+    return partition;
+}
+
+static bool is_active(t_scc_state *state, int vertex) {
+    return atomic_load_explicit(&state->component[vertex], memory_order_relaxed) == -1;
+}
+
+static void sweep_bounds(t_sweep *sweep, int task, int *begin, int *end) {
+    *begin = (int) ((long long) sweep->item_count * task / sweep->task_count);
+    *end = (int) ((long long) sweep->item_count * (task + 1) / sweep->task_count);
+}
+
+static void run_sweep(t_scc_state *state, t_sweep *sweep, t_task task) {
+    int max_tasks = state->pool != NULL ? state->pool->thread_count * 4 : 1;
+    sweep->state = state;
+    sweep->task_count = sweep->item_count / SCC_BLOCK_SIZE + 1;
+    if (sweep->task_count > max_tasks) sweep->task_count = max_tasks;
+
+    run_parallel(sweep->task_count > 1 ? state->pool : NULL, sweep->task_count, task, sweep);
+}
+
+// Remplace la liste des sommets actifs par ceux qui n'ont pas encore de classe
+static void compact_active(t_scc_state *state) {
+    int count = 0;
+    for (int i = 0; i < state->active_count; i++) {
+        if (is_active(state, state->active[i])) state->active[count++] = state->active[i];
+    }
+    state->active_count = count;
+}
+
+// Regroupe les blocs de sortie dans une seule frontière
+static void gather_outputs(t_sweep *sweep, t_stack *frontier) {
+    frontier->size = 0;
+    for (int t = 0; t < sweep->task_count; t++) {
+        for (int i = 0; i < sweep->outputs[t].size; i++) {
+            push(frontier, sweep->outputs[t].values[i]);
+        }
+        sweep->outputs[t].size = 0;
+    }
+}
+
+static bool has_active_neighbor(t_scc_state *state, const t_adj_list *graph, int vertex) {
+    for (int e = graph->offsets[vertex]; e < graph->offsets[vertex + 1]; e++) {
+        int neighbor = graph->dest[e];
+        if (neighbor != vertex && is_active(state, neighbor)) return true;
+    }
+    return false;
+}
+
+// Un sommet sans successeur ou sans prédécesseur actif forme une classe à lui seul
+static void trim_task(void *context, int task) {
+    t_sweep *sweep = context;
+    t_scc_state *state = sweep->state;
+    int begin, end, trimmed = 0;
+    sweep_bounds(sweep, task, &begin, &end);
+
+    for (int i = begin; i < end; i++) {
+        int vertex = sweep->items[i];
+        if (!has_active_neighbor(state, state->graph, vertex) || !has_active_neighbor(state, &state->reverse, vertex)) {
+            atomic_store_explicit(&state->component[vertex], vertex, memory_order_relaxed);
+            trimmed++;
+        }
+    }
+    atomic_fetch_add(&state->trimmed, trimmed);
+}
+
+static void trim(t_scc_state *state) {
+    for (int round = 0; round < SCC_MAX_TRIM_ROUNDS && state->active_count > 0; round++) {
+        t_sweep sweep = { .items = state->active, .item_count = state->active_count };
+        atomic_store(&state->trimmed, 0);
+        run_sweep(state, &sweep, trim_task);
+
+        int trimmed = atomic_load(&state->trimmed);
+        compact_active(state);
+        if (trimmed == 0 || trimmed < state->active_count / 100) break;
+    }
+}
+
+// Parcours en largeur par niveaux : marque (bit value) les sommets actifs atteints depuis la frontière
+static void reach_task(void *context, int task) {
+    t_sweep *sweep = context;
+    t_scc_state *state = sweep->state;
+    int begin, end;
+    sweep_bounds(sweep, task, &begin, &end);
+
+    for (int i = begin; i < end; i++) {
+        int vertex = sweep->items[i];
+        for (int e = sweep->graph->offsets[vertex]; e < sweep->graph->offsets[vertex + 1]; e++) {
+            int neighbor = sweep->graph->dest[e];
+            if (!is_active(state, neighbor)) continue;
+
+            int previous = atomic_fetch_or_explicit(&state->color[neighbor], sweep->value, memory_order_relaxed);
+            if ((previous & sweep->value) == 0) push(&sweep->outputs[task], neighbor);
+        }
+    }
+}
+
+static void reach(t_scc_state *state, const t_adj_list *graph, int source, int mark, t_stack *outputs) {
+    t_stack frontier = create_stack(SCC_BLOCK_SIZE);
+    atomic_fetch_or(&state->color[source], mark);
+    push(&frontier, source);
+
+    while (!is_empty(frontier)) {
+        t_sweep sweep = { .items = frontier.values, .item_count = frontier.size, .outputs = outputs, .graph = graph, .value = mark };
+        run_sweep(state, &sweep, reach_task);
+        gather_outputs(&sweep, &frontier);
+    }
+
+    free_stack(&frontier);
+}
+
+// Avant/arrière : la classe du pivot est l'intersection de ses descendants et de ses ancêtres
+static void forward_backward(t_scc_state *state, t_stack *outputs) {
+    int pivot = state->active[0];
+    long long best_score = -1;
+
+    for (int i = 0; i < state->active_count; i++) {
+        int v = state->active[i];
+        long long out_degree = state->graph->offsets[v + 1] - state->graph->offsets[v];
+        long long in_degree = state->reverse.offsets[v + 1] - state->reverse.offsets[v];
+        if (out_degree * in_degree > best_score) {
+            best_score = out_degree * in_degree;
+            pivot = v;
+        }
+    }
+
+    for (int i = 0; i < state->active_count; i++) {
+        atomic_store_explicit(&state->color[state->active[i]], 0, memory_order_relaxed);
+    }
+
+    reach(state, state->graph, pivot, MARK_FORWARD, outputs);
+    reach(state, &state->reverse, pivot, MARK_BACKWARD, outputs);
+
+    for (int i = 0; i < state->active_count; i++) {
+        int v = state->active[i];
+        if (atomic_load_explicit(&state->color[v], memory_order_relaxed) == (MARK_FORWARD | MARK_BACKWARD)) {
+            atomic_store_explicit(&state->component[v], pivot, memory_order_relaxed);
+        }
+    }
+    compact_active(state);
+}
+
+// Propagation de la plus grande couleur le long des arêtes
+static void color_task(void *context, int task) {
+    t_sweep *sweep = context;
+    t_scc_state *state = sweep->state;
+    int begin, end;
+    sweep_bounds(sweep, task, &begin, &end);
+
+    for (int i = begin; i < end; i++) {
+        int vertex = sweep->items[i];
+        int color = atomic_load_explicit(&state->color[vertex], memory_order_relaxed);
+
+        for (int e = state->graph->offsets[vertex]; e < state->graph->offsets[vertex + 1]; e++) {
+            int neighbor = state->graph->dest[e];
+            if (neighbor == vertex || !is_active(state, neighbor)) continue;
+
+            int previous = atomic_load_explicit(&state->color[neighbor], memory_order_relaxed);
+            bool raised = false;
+            while (previous < color && !raised) {
+                raised = atomic_compare_exchange_weak_explicit(&state->color[neighbor], &previous, color,
+                                                               memory_order_relaxed, memory_order_relaxed);
+            }
+
+            if (raised && atomic_exchange_explicit(&state->queued[neighbor], sweep->value, memory_order_relaxed) != sweep->value) {
+                push(&sweep->outputs[task], neighbor);
+            }
+        }
+    }
+}
+
+// Pour chaque racine (sommet dont la couleur est son propre id), la classe est l'ensemble
+// des sommets de même couleur qui atteignent la racine
+static void collect_task(void *context, int task) {
+    t_sweep *sweep = context;
+    t_scc_state *state = sweep->state;
+    t_stack *pending = &sweep->outputs[task];
+    int begin, end;
+    sweep_bounds(sweep, task, &begin, &end);
+
+    for (int i = begin; i < end; i++) {
+        int root = sweep->items[i];
+        atomic_store_explicit(&state->component[root], root, memory_order_relaxed);
+        push(pending, root);
+
+        while (!is_empty(*pending)) {
+            int vertex = pop(pending);
+            for (int e = state->reverse.offsets[vertex]; e < state->reverse.offsets[vertex + 1]; e++) {
+                int neighbor = state->reverse.dest[e];
+                if (is_active(state, neighbor) && atomic_load_explicit(&state->color[neighbor], memory_order_relaxed) == root) {
+                    atomic_store_explicit(&state->component[neighbor], root, memory_order_relaxed);
+                    push(pending, neighbor);
+                }
+            }
+        }
+    }
+}
+
+static void coloring(t_scc_state *state, t_stack *outputs) {
+    t_stack frontier = create_stack(state->active_count);
+    int round = 0;
+
+    for (int i = 0; i < state->active_count; i++) {
+        int v = state->active[i];
+        atomic_store_explicit(&state->color[v], v, memory_order_relaxed);
+        atomic_store_explicit(&state->queued[v], 0, memory_order_relaxed);
+        push(&frontier, v);
+    }
+
+    while (!is_empty(frontier)) {
+        round++;
+        t_sweep sweep = { .items = frontier.values, .item_count = frontier.size, .outputs = outputs, .value = round };
+        run_sweep(state, &sweep, color_task);
+        gather_outputs(&sweep, &frontier);
+    }
+
+    for (int i = 0; i < state->active_count; i++) {
+        int v = state->active[i];
+        if (atomic_load_explicit(&state->color[v], memory_order_relaxed) == v) push(&frontier, v);
+    }
+
+    t_sweep sweep = { .items = frontier.values, .item_count = frontier.size, .outputs = outputs };
+    run_sweep(state, &sweep, collect_task);
+
+    free_stack(&frontier);
+    compact_active(state);
+}
+
+// Termine séquentiellement avec Tarjan : les sommets déjà classés sont vus comme visités et hors pile
+static void finish_with_tarjan(t_scc_state *state) {
+    t_adj_list *graph = state->graph;
+    t_tarjan_vertex *tarjan_array = create_tarjan_array(graph);
+    t_tarjan_frame *frames = malloc((graph->length > 0 ? graph->length : 1) * sizeof(t_tarjan_frame));
+    t_stack stack = create_stack(state->active_count);
+    t_partition remaining = create_partition(state->active_count / 2 + 1);
+    if (tarjan_array == NULL || frames == NULL) exit(EXIT_FAILURE);
+
+    for (int v = 0; v < graph->length; v++) {
+        if (!is_active(state, v)) tarjan_array[v].index = 0;
+    }
+
+    int timer = 0;
+    for (int i = 0; i < state->active_count; i++) {
+        int v = state->active[i];
+        if (tarjan_array[v].index == -1) {
+            parcours(v, graph, tarjan_array, &stack, frames, &remaining, &timer);
+        }
+    }
+
+    for (int c = 0; c < remaining.class_count; c++) {
+        t_classe *class = &remaining.classes[c];
+        int representative = class->vertex_ids[0] - 1;
+        for (int j = 0; j < class->vertex_count; j++) {
+            atomic_store_explicit(&state->component[class->vertex_ids[j] - 1], representative, memory_order_relaxed);
+        }
+    }
+    state->active_count = 0;
+
+    free_partition(&remaining);
+    free_stack(&stack);
+    free(frames);
+    free(tarjan_array);
+}
+
+// Construit la partition à partir des représentants, dans l'ordre canonique
+static t_partition build_partition(t_scc_state *state) {
+    int length = state->graph->length;
+    int *class_of = malloc((length > 0 ? length : 1) * sizeof(int));
+    if (class_of == NULL) exit(EXIT_FAILURE);
+    for (int v = 0; v < length; v++) class_of[v] = -1;
+
+    t_partition partition = create_partition(length / 2 + 1);
+    int *vertex_class = malloc((length > 0 ? length : 1) * sizeof(int));
+    if (vertex_class == NULL) exit(EXIT_FAILURE);
+
+    for (int v = 0; v < length; v++) {
+        int representative = atomic_load_explicit(&state->component[v], memory_order_relaxed);
+        if (class_of[representative] == -1) {
+            t_classe new_class;
+            new_class.vertex_ids = NULL;
+            new_class.vertex_count = 0;
+            new_class.capacity = 0;
+            class_of[representative] = add_class(&partition, new_class);
+        }
+        vertex_class[v] = class_of[representative];
+        partition.classes[vertex_class[v]].capacity++;
+    }
+
+    for (int c = 0; c < partition.class_count; c++) {
+        partition.classes[c].vertex_ids = malloc(partition.classes[c].capacity * sizeof(int));
+        if (partition.classes[c].vertex_ids == NULL) exit(EXIT_FAILURE);
+    }
+    for (int v = 0; v < length; v++) {
+        t_classe *class = &partition.classes[vertex_class[v]];
+        class->vertex_ids[class->vertex_count++] = v + 1;
+    }
+
+    free(vertex_class);
+    free(class_of);
+    return partition;
+}
+
+t_partition parallel_scc(t_adj_list *graph) {
+    t_scc_state state;
+    int length = graph->length;
+
+    state.graph = graph;
+    state.reverse = transpose_adjlist(graph);
+    state.pool = pool_for_work(length + (long) graph->edge_count);
+    state.component = malloc((length > 0 ? length : 1) * sizeof(atomic_int));
+    state.color = malloc((length > 0 ? length : 1) * sizeof(atomic_int));
+    state.queued = malloc((length > 0 ? length : 1) * sizeof(atomic_int));
+    state.active = malloc((length > 0 ? length : 1) * sizeof(int));
+    if (state.component == NULL || state.color == NULL || state.queued == NULL || state.active == NULL) exit(EXIT_FAILURE);
+
+    for (int v = 0; v < length; v++) {
+        atomic_init(&state.component[v], -1);
+        atomic_init(&state.color[v], 0);
+        atomic_init(&state.queued[v], 0);
+        state.active[v] = v;
+    }
+    state.active_count = length;
+    atomic_init(&state.trimmed, 0);
+
+    int output_count = state.pool != NULL ? state.pool->thread_count * 4 : 1;
+    t_stack *outputs = malloc(output_count * sizeof(t_stack));
+    if (outputs == NULL) exit(EXIT_FAILURE);
+    for (int t = 0; t < output_count; t++) outputs[t] = create_stack(SCC_BLOCK_SIZE);
+
+    trim(&state);
+    if (state.active_count > SCC_SEQUENTIAL_CUTOFF) {
+        forward_backward(&state, outputs);
+        trim(&state);
+    }
+    while (state.active_count > SCC_SEQUENTIAL_CUTOFF) {
+        coloring(&state, outputs);
+        trim(&state);
+    }
+    if (state.active_count > 0) finish_with_tarjan(&state);
+
+    t_partition partition = build_partition(&state);
+
+    for (int t = 0; t < output_count; t++) free_stack(&outputs[t]);
+    free(outputs);
+    free(state.active);
+    free(state.queued);
+    free(state.color);
+    free(state.component);
+    free_adjlist(&state.reverse);
+    return partition;
+}
+
+static int compare_ints(const void *a, const void *b) {
+    int x = *(const int *) a, y = *(const int *) b;
+    return (x > y) - (x < y);
+}
+
+static int compare_classes(const void *a, const void *b) {
+    const t_classe *x = a, *y = b;
+    return compare_ints(&x->vertex_ids[0], &y->vertex_ids[0]);
+}
+
+void sort_partition(t_partition *partition) {
+    for (int c = 0; c < partition->class_count; c++) {
+        t_classe *class = &partition->classes[c];
+        qsort(class->vertex_ids, class->vertex_count, sizeof(int), compare_ints);
+    }
+    qsort(partition->classes, partition->class_count, sizeof(t_classe), compare_classes);
+
+    for (int c = 0; c < partition->class_count; c++) {
+        snprintf(partition->classes[c].name, sizeof(partition->classes[c].name), "C%d", c + 1);
+    }
+}
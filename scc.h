@@ -0,0 +1,49 @@
+#ifndef __SCC_H__
+#define __SCC_H__
+
+#include "utils.h"
+#include "hasse.h"
+
+// Moteur de calcul des composantes fortement connexes
+typedef enum e_scc_engine {
+    SCC_TARJAN,                     // Tarjan séquentiel (hasse.c)
+    SCC_PARALLEL                    // Élagage + avant/arrière + coloration, multi-threadé
+} t_scc_engine;
+
+/**
+ * @brief Convertit un nom de moteur ("tarjan" ou "parallel") en t_scc_engine.
+ * @param name Le nom du moteur.
+ * @param engine Pointeur vers le moteur reconnu.
+ * @return true si le nom est reconnu.
+ */
+bool parse_scc_engine(const char *name, t_scc_engine *engine);
+
+/**
+ * @brief Calcule les classes du graphe avec le moteur demandé, dans l'ordre canonique de
+ * sort_partition() : les deux moteurs rendent la même partition (mêmes noms C1, C2, ...).
+ * @param graph Pointeur vers le graphe.
+ * @param engine Le moteur à utiliser.
+ * @return La partition en classes.
+ */
+t_partition find_scc(t_adj_list *graph, t_scc_engine engine);
+
+/**
+ * @brief Calcule les classes du graphe en parallèle (algorithme "multistep") :
+ * élagage des sommets sans prédécesseur ou sans successeur actif, parcours avant/arrière
+ * depuis un pivot pour extraire la grande classe, puis coloration pour les autres ;
+ * le reliquat est confié à Tarjan.
+ * Les classes sont celles de tarjan() (à l'ordre près), dans l'ordre canonique de sort_partition().
+ * @param graph Pointeur vers le graphe.
+ * @return La partition en classes.
+ */
+t_partition parallel_scc(t_adj_list *graph);
+
+/**
+ * @brief Met une partition dans l'ordre canonique : sommets croissants dans chaque classe,
+ * classes triées par plus petit sommet, puis renommées C1, C2, ...
+ * Deux partitions identiques à l'ordre près deviennent égales.
+ * @param partition Pointeur vers la partition.
+ */
+void sort_partition(t_partition *partition);
+
+#endif // __SCC_H__
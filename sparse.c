@@ -0,0 +1,324 @@
+#include "sparse.h"
+#include "threads.h"
+#include <limits.h>
+#include <stdatomic.h>
+
+// Lignes d'un bloc du produit, dans des tampons propres au bloc
+typedef struct s_row_block {
+    int begin;                      // Première ligne du bloc
+    int end;                        // Ligne suivant la dernière
+    int count;                      // Nombre de coefficients
+    int capacity;                   // Capacité des tampons
+    int *dest;                      // Colonnes
+    float *proba;                   // Valeurs
+    int *row_counts;                // Coefficients de chaque ligne du bloc
+} t_row_block;
+
+// Case de l'accumulateur dense : valeur et marque de la dernière ligne qui l'a touchée (un seul accès mémoire)
+typedef struct s_accumulator {
+    double value;
+    int tag;
+} t_accumulator;
+
+// Tampons O(n) d'un thread, alloués au premier usage et réutilisés par tous ses blocs et produits
+typedef struct s_spgemm_scratch {
+    t_accumulator *accumulator;     // Accumulateur dense de la ligne en cours
+    int *columns;                   // Colonnes touchées par la ligne en cours
+    int tag;                        // Marque de la ligne en cours (croissante, jamais réutilisée)
+} t_spgemm_scratch;
+
+// Tampons de tous les threads, partagés par les produits successifs de power_sparse
+typedef struct s_spgemm_workspace {
+    int length;                     // Nombre de colonnes
+    int count;                      // Nombre de tampons (un par tâche, 1 sans pool)
+    t_spgemm_scratch *scratch;      // Tampons
+} t_spgemm_workspace;
+
+// Contexte partagé du produit A * B : chaque tâche prend des blocs de lignes au fil de l'eau
+typedef struct s_spgemm_task {
+    const t_adj_list *matrix_A;
+    const t_adj_list *matrix_B;
+    float drop_tolerance;
+    t_row_block *blocks;
+    int block_count;
+    atomic_int next_block;          // Prochain bloc à calculer
+    t_spgemm_workspace *workspace;
+} t_spgemm_task;
+
+// Espace vide : les tampons sont ajoutés par ensure_spgemm_scratch selon le pool réellement utilisé
+static t_spgemm_workspace create_spgemm_workspace(int length) {
+    t_spgemm_workspace workspace = { .length = length, .count = 0, .scratch = NULL };
+    return workspace;
+}
+
+static void ensure_spgemm_scratch(t_spgemm_workspace *workspace, int count) {
+    if (count <= workspace->count) return;
+    workspace->scratch = realloc(workspace->scratch, count * sizeof(t_spgemm_scratch));
+    if (workspace->scratch == NULL) exit(EXIT_FAILURE);
+    memset(workspace->scratch + workspace->count, 0, (count - workspace->count) * sizeof(t_spgemm_scratch));
+    workspace->count = count;
+}
+
+static void free_spgemm_workspace(t_spgemm_workspace *workspace) {
+    for (int t = 0; t < workspace->count; t++) {
+        free(workspace->scratch[t].accumulator);
+        free(workspace->scratch[t].columns);
+    }
+    free(workspace->scratch);
+}
+
+static void init_scratch(t_spgemm_scratch *scratch, int length) {
+    scratch->accumulator = malloc((length > 0 ? length : 1) * sizeof(t_accumulator));
+    scratch->columns = malloc((length > 0 ? length : 1) * sizeof(int));
+    if (scratch->accumulator == NULL || scratch->columns == NULL) exit(EXIT_FAILURE);
+    for (int j = 0; j < length; j++) {
+        scratch->accumulator[j].tag = -1;
+    }
+    scratch->tag = -1;
+}
+
+static int compare_ints(const void *a, const void *b) {
+    int x = *(const int *) a, y = *(const int *) b;
+    return (x > y) - (x < y);
+}
+
+// Tri des colonnes d'une ligne : insertion pour les lignes courtes (cas courant), qsort sinon
+static void sort_columns(int *columns, int count) {
+    if (count > 32) {
+        qsort(columns, count, sizeof(int), compare_ints);
+        return;
+    }
+    for (int t = 1; t < count; t++) {
+        int value = columns[t], u = t - 1;
+        while (u >= 0 && columns[u] > value) {
+            columns[u + 1] = columns[u];
+            u--;
+        }
+        columns[u + 1] = value;
+    }
+}
+
+static void spgemm_block(t_spgemm_task *task, t_spgemm_scratch *scratch, t_row_block *block) {
+    const t_adj_list *a = task->matrix_A;
+    const t_adj_list *b = task->matrix_B;
+    t_accumulator *accumulator = scratch->accumulator;
+    int *columns = scratch->columns;
+
+    block->row_counts = malloc((block->end - block->begin > 0 ? block->end - block->begin : 1) * sizeof(int));
+    block->capacity = 1024;
+    block->count = 0;
+    block->dest = malloc(block->capacity * sizeof(int));
+    block->proba = malloc(block->capacity * sizeof(float));
+    if (block->row_counts == NULL || block->dest == NULL || block->proba == NULL) exit(EXIT_FAILURE);
+
+    for (int i = block->begin; i < block->end; i++) {
+        // Nouvelle marque par ligne : l'accumulateur n'est jamais remis à zéro, sauf au débordement
+        if (scratch->tag == INT_MAX) {
+            for (int j = 0; j < b->length; j++) accumulator[j].tag = -1;
+            scratch->tag = -1;
+        }
+        int tag = ++scratch->tag;
+
+        int touched = 0;
+        for (int e = a->offsets[i]; e < a->offsets[i + 1]; e++) {
+            int k = a->dest[e];
+            double factor = a->proba[e];
+            for (int f = b->offsets[k]; f < b->offsets[k + 1]; f++) {
+                int j = b->dest[f];
+                if (accumulator[j].tag != tag) {
+                    accumulator[j].tag = tag;
+                    accumulator[j].value = 0.0;
+                    columns[touched++] = j;
+                }
+                accumulator[j].value += factor * b->proba[f];
+            }
+        }
+        sort_columns(columns, touched);
+
+        if (block->count + touched > block->capacity) {
+            while (block->count + touched > block->capacity) block->capacity *= 2;
+            block->dest = realloc(block->dest, block->capacity * sizeof(int));
+            block->proba = realloc(block->proba, block->capacity * sizeof(float));
+            if (block->dest == NULL || block->proba == NULL) exit(EXIT_FAILURE);
+        }
+
+        int kept = 0;
+        for (int t = 0; t < touched; t++) {
+            int j = columns[t];
+            if (task->drop_tolerance > 0.0f && accumulator[j].value <= task->drop_tolerance) continue;
+            block->dest[block->count + kept] = j;
+            block->proba[block->count + kept] = (float) accumulator[j].value;
+            kept++;
+        }
+        block->count += kept;
+        block->row_counts[i - block->begin] = kept;
+    }
+}
+
+// Tâche t : tampons t (alloués une fois), puis blocs pris dans l'ordre jusqu'à épuisement
+static void spgemm_task(void *context, int task_index) {
+    t_spgemm_task *task = context;
+    t_spgemm_scratch *scratch = &task->workspace->scratch[task_index];
+    if (scratch->accumulator == NULL) init_scratch(scratch, task->workspace->length);
+
+    int block;
+    while ((block = atomic_fetch_add(&task->next_block, 1)) < task->block_count) {
+        spgemm_block(task, scratch, &task->blocks[block]);
+    }
+}
+
+static t_adj_list multiply_sparse_with(const t_adj_list *matrix_A, const t_adj_list *matrix_B, float drop_tolerance,
+                                       t_spgemm_workspace *workspace) {
+    if (matrix_A->length != matrix_B->length) exit(EXIT_FAILURE);
+    int length = matrix_A->length;
+
+    // Travail de chaque ligne : nombre de produits a_ik * b_kj
+    long long *work = malloc((length + 1) * sizeof(long long));
+    if (work == NULL) exit(EXIT_FAILURE);
+    work[0] = 0;
+    for (int i = 0; i < length; i++) {
+        long long row_work = 1;
+        for (int e = matrix_A->offsets[i]; e < matrix_A->offsets[i + 1]; e++) {
+            int k = matrix_A->dest[e];
+            row_work += matrix_B->offsets[k + 1] - matrix_B->offsets[k];
+        }
+        work[i + 1] = work[i] + row_work;
+    }
+
+    t_thread_pool *pool = pool_for_work(work[length]);
+    int block_count = pool != NULL ? pool->thread_count * 4 : 1;
+    if (block_count > length) block_count = length > 0 ? length : 1;
+
+    t_spgemm_task task = {
+        .matrix_A = matrix_A, .matrix_B = matrix_B, .drop_tolerance = drop_tolerance,
+        .block_count = block_count, .workspace = workspace
+    };
+    atomic_init(&task.next_block, 0);
+    task.blocks = malloc(block_count * sizeof(t_row_block));
+    if (task.blocks == NULL) exit(EXIT_FAILURE);
+
+    // Blocs de travail équilibré : première ligne i telle que work[i] >= total * b / block_count
+    int begin = 0;
+    for (int b = 0; b < block_count; b++) {
+        long long target = work[length] * (b + 1) / block_count;
+        int low = begin, high = length;
+        while (low < high) {
+            int mid = low + (high - low) / 2;
+            if (work[mid] < target) low = mid + 1;
+            else high = mid;
+        }
+        task.blocks[b].begin = begin;
+        task.blocks[b].end = b == block_count - 1 ? length : low;
+        begin = task.blocks[b].end;
+    }
+    free(work);
+
+    int task_count = pool != NULL ? pool->thread_count : 1;
+    ensure_spgemm_scratch(workspace, task_count);
+    run_parallel(pool, task_count, spgemm_task, &task);
+
+    // Concaténation des blocs
+    long long edge_count = 0;
+    for (int b = 0; b < block_count; b++) {
+        edge_count += task.blocks[b].count;
+    }
+    if (edge_count > INT_MAX) {
+        fprintf(stderr, "Trop de coefficients dans le produit (%lld).\n", edge_count);
+        exit(EXIT_FAILURE);
+    }
+
+    t_adj_list product = create_empty_adjlist(length);
+    product.edge_count = (int) edge_count;
+    product.dest = malloc((edge_count > 0 ? edge_count : 1) * sizeof(int));
+    product.proba = malloc((edge_count > 0 ? edge_count : 1) * sizeof(float));
+    if (product.dest == NULL || product.proba == NULL) exit(EXIT_FAILURE);
+
+    int position = 0;
+    for (int b = 0; b < block_count; b++) {
+        t_row_block *block = &task.blocks[b];
+        for (int i = block->begin; i < block->end; i++) {
+            product.offsets[i + 1] = product.offsets[i] + block->row_counts[i - block->begin];
+        }
+        memcpy(product.dest + position, block->dest, block->count * sizeof(int));
+        memcpy(product.proba + position, block->proba, block->count * sizeof(float));
+        position += block->count;
+
+        free(block->row_counts);
+        free(block->dest);
+        free(block->proba);
+    }
+    free(task.blocks);
+    return product;
+}
+
+t_adj_list multiply_sparse(const t_adj_list *matrix_A, const t_adj_list *matrix_B, float drop_tolerance) {
+    t_spgemm_workspace workspace = create_spgemm_workspace(matrix_B->length);
+    t_adj_list product = multiply_sparse_with(matrix_A, matrix_B, drop_tolerance, &workspace);
+    free_spgemm_workspace(&workspace);
+    return product;
+}
+
+static t_adj_list copy_adjlist(const t_adj_list *graph) {
+    t_adj_list copy = create_empty_adjlist(graph->length);
+    copy.edge_count = graph->edge_count;
+    copy.dest = malloc((graph->edge_count > 0 ? graph->edge_count : 1) * sizeof(int));
+    copy.proba = malloc((graph->edge_count > 0 ? graph->edge_count : 1) * sizeof(float));
+    if (copy.dest == NULL || copy.proba == NULL) exit(EXIT_FAILURE);
+
+    memcpy(copy.offsets, graph->offsets, (graph->length + 1) * sizeof(int));
+    memcpy(copy.dest, graph->dest, graph->edge_count * sizeof(int));
+    memcpy(copy.proba, graph->proba, graph->edge_count * sizeof(float));
+    return copy;
+}
+
+t_adj_list power_sparse(const t_adj_list *graph, int p, float drop_tolerance) {
+    if (p < 1) return create_empty_adjlist(graph->length);
+
+    // Exponentiation rapide, comme power_matrix_into : square parcourt P, P^2, P^4, ...
+    t_adj_list square = copy_adjlist(graph);
+    t_adj_list acc;
+    t_spgemm_workspace workspace = create_spgemm_workspace(graph->length);
+    bool first = true;
+
+    while (p > 0) {
+        if (p & 1) {
+            if (first) {
+                acc = copy_adjlist(&square);
+                first = false;
+            } else {
+                t_adj_list next = multiply_sparse_with(&acc, &square, drop_tolerance, &workspace);
+                free_adjlist(&acc);
+                acc = next;
+            }
+        }
+
+        p >>= 1;
+        if (p > 0) {
+            t_adj_list next = multiply_sparse_with(&square, &square, drop_tolerance, &workspace);
+            free_adjlist(&square);
+            square = next;
+        }
+    }
+
+    free_adjlist(&square);
+    free_spgemm_workspace(&workspace);
+    return acc;
+}
+
+void display_sparse_matrix(const t_adj_list *matrix, int max_rows) {
+    double density = matrix->length > 0 ? (double) matrix->edge_count / ((double) matrix->length * matrix->length) : 0.0;
+    printf("Matrice creuse (%d x %d, %d coefficients, densite %.4f%%) :\n",
+           matrix->length, matrix->length, matrix->edge_count, 100.0 * density);
+
+    int shown = matrix->length < max_rows ? matrix->length : max_rows;
+    for (int i = 0; i < shown; i++) {
+        printf("  Ligne %d :", i + 1);
+        for (int e = matrix->offsets[i]; e < matrix->offsets[i + 1]; e++) {
+            printf(" %d:%.4f", matrix->dest[e] + 1, matrix->proba[e]);
+        }
+        printf("\n");
+    }
+    if (shown < matrix->length) {
+        printf("  ... (%d lignes)\n", matrix->length);
+    }
+}
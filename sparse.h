@@ -0,0 +1,40 @@
+#ifndef __SPARSE_H__
+#define __SPARSE_H__
+
+#include "utils.h"
+
+#define SPARSE_DROP_TOLERANCE 0.0f          // Seuil d'élimination par défaut (0 : aucun coefficient retiré)
+
+/**
+ * @brief Multiplie deux matrices creuses au format CSR (algorithme de Gustavson) : chaque ligne
+ * de A * B est accumulée dans un tableau dense propre à chaque thread, puis compressée. Le coût est
+ * proportionnel au nombre de produits non nuls, sans terme en n^3 ni matrice n x n.
+ * Les lignes sont découpées en blocs de travail équilibré que les threads se partagent ; chaque
+ * thread alloue son accumulateur une seule fois et le réutilise pour tous ses blocs.
+ * @param matrix_A Pointeur vers la matrice de gauche (un graphe).
+ * @param matrix_B Pointeur vers la matrice de droite (même nombre de sommets).
+ * @param drop_tolerance Les coefficients du produit inférieurs ou égaux à ce seuil sont retirés
+ * (masse non redistribuée) ; 0 garde tous les coefficients non nuls.
+ * @return Le produit, colonnes croissantes dans chaque ligne (à libérer avec free_adjlist).
+ */
+t_adj_list multiply_sparse(const t_adj_list *matrix_A, const t_adj_list *matrix_B, float drop_tolerance);
+
+/**
+ * @brief Élève la matrice de transition creuse à la puissance p par exponentiation rapide
+ * (O(log p) produits creux). Le seuil d'élimination s'applique à chaque produit et limite le
+ * remplissage des puissances élevées. Les accumulateurs des threads sont partagés par tous les produits.
+ * @param graph Pointeur vers le graphe.
+ * @param p La puissance (matrice nulle si p < 1, comme power_matrix).
+ * @param drop_tolerance Seuil d'élimination des petits coefficients.
+ * @return P^p au format CSR (à libérer avec free_adjlist).
+ */
+t_adj_list power_sparse(const t_adj_list *graph, int p, float drop_tolerance);
+
+/**
+ * @brief Affiche le nombre de coefficients et les premières lignes d'une matrice creuse.
+ * @param matrix Pointeur vers la matrice.
+ * @param max_rows Nombre maximal de lignes affichées.
+ */
+void display_sparse_matrix(const t_adj_list *matrix, int max_rows);
+
+#endif // __SPARSE_H__
@@ -0,0 +1,696 @@
+#include "stationary.h"
+#include "threads.h"
+#include "matrix.h"
+#include <math.h>
+#include <float.h>
+#include <complex.h>
+
+// Contexte partagé du produit pi P, découpé en blocs de sommets de poids (sommets + arêtes) équilibrés
+typedef struct s_spmv_task {
+    const t_adj_list *transpose;    // Graphe transposé : arêtes entrantes de chaque état
+    const int *block_starts;        // Premier sommet de chaque bloc (block_count + 1 cases)
+    const double *current;          // pi
+    double *next;                   // pi P, puis pi P normalisé
+    double scale;                   // Facteur de normalisation de next
+    bool lazy;                      // Produit par la chaîne paresseuse (I + P) / 2
+    double *partial_sums;           // Une somme partielle par bloc
+} t_spmv_task;
+
+static void spmv_task(void *context, int block) {
+    t_spmv_task *task = context;
+    const t_adj_list *transpose = task->transpose;
+    double block_sum = 0.0;
+
+    for (int v = task->block_starts[block]; v < task->block_starts[block + 1]; v++) {
+        double sum = 0.0;
+        for (int e = transpose->offsets[v]; e < transpose->offsets[v + 1]; e++) {
+            sum += task->current[transpose->dest[e]] * transpose->proba[e];
+        }
+        if (task->lazy) sum = 0.5 * (sum + task->current[v]);
+        task->next[v] = sum;
+        block_sum += sum;
+    }
+    task->partial_sums[block] = block_sum;
+}
+
+static void normalize_task(void *context, int block) {
+    t_spmv_task *task = context;
+    double block_diff = 0.0;
+
+    for (int v = task->block_starts[block]; v < task->block_starts[block + 1]; v++) {
+        task->next[v] *= task->scale;
+        block_diff += fabs(task->next[v] - task->current[v]);
+    }
+    task->partial_sums[block] = block_diff;
+}
+
+// Somme des blocs dans l'ordre : le résultat ne dépend pas du nombre de threads
+static double sum_blocks(const double *partial_sums, int block_count) {
+    double sum = 0.0;
+    for (int b = 0; b < block_count; b++) {
+        sum += partial_sums[b];
+    }
+    return sum;
+}
+
+// Opérateur x -> x P sur le graphe transposé, préparé une fois par calcul
+typedef struct s_spmv_operator {
+    t_adj_list transpose;           // Graphe transposé
+    t_thread_pool *pool;            // Pool utilisé (NULL si séquentiel)
+    int block_count;                // Nombre de blocs de sommets
+    t_spmv_task task;               // Contexte des tâches
+} t_spmv_operator;
+
+static void init_operator(t_spmv_operator *op, t_adj_list *graph) {
+    op->transpose = transpose_adjlist(graph);
+    op->pool = pool_for_work((long) graph->length + graph->edge_count);
+    op->block_count = op->pool != NULL ? op->pool->thread_count * 4 : 1;
+
+    op->task.transpose = &op->transpose;
+    op->task.lazy = false;
+    op->task.block_starts = balanced_blocks(&op->transpose, op->block_count);
+    op->task.partial_sums = malloc(op->block_count * sizeof(double));
+    if (op->task.partial_sums == NULL) exit(EXIT_FAILURE);
+}
+
+// Calcule y = x P et retourne la somme des composantes de y
+static double apply_operator(t_spmv_operator *op, const double *x, double *y) {
+    op->task.current = x;
+    op->task.next = y;
+    run_parallel(op->pool, op->block_count, spmv_task, &op->task);
+    return sum_blocks(op->task.partial_sums, op->block_count);
+}
+
+// Normalise y (somme 1) et retourne ||y - x||_1
+static double normalize_difference(t_spmv_operator *op, const double *x, double *y, double mass) {
+    op->task.current = x;
+    op->task.next = y;
+    op->task.scale = 1.0 / mass;
+    run_parallel(op->pool, op->block_count, normalize_task, &op->task);
+    return sum_blocks(op->task.partial_sums, op->block_count);
+}
+
+static void free_operator(t_spmv_operator *op) {
+    free(op->task.partial_sums);
+    free((int *) op->task.block_starts);
+    free_adjlist(&op->transpose);
+}
+
+static t_stationary create_stationary(int length) {
+    t_stationary stationary;
+    stationary.length = length;
+    stationary.iterations = 0;
+    stationary.residual = INFINITY;
+    stationary.second_eigenvalue = NAN;
+    stationary.cesaro_period = 1;
+    stationary.converged = false;
+    stationary.distribution = malloc((length > 0 ? length : 1) * sizeof(double));
+    if (stationary.distribution == NULL) exit(EXIT_FAILURE);
+
+    for (int i = 0; i < length; i++) {
+        stationary.distribution[i] = 1.0 / length;
+    }
+    return stationary;
+}
+
+t_stationary stationary_power_iteration(t_adj_list *graph, double tolerance, int max_iterations) {
+    int length = graph->length;
+    t_stationary stationary = create_stationary(length);
+    if (length == 0) return stationary;
+
+    double *next = malloc(length * sizeof(double));
+    if (next == NULL) exit(EXIT_FAILURE);
+
+    t_spmv_operator op;
+    init_operator(&op, graph);
+
+    // Chaîne périodique : pi P^n oscille. Le départ devient la moyenne de d itérés successifs
+    // (moyenne de Cesàro), où les composantes des valeurs propres de module 1 autres que 1
+    // s'annulent ; pi <- pi P converge ensuite normalement. Au-delà de STATIONARY_MAX_PERIOD,
+    // on itère sur la chaîne paresseuse (I + P) / 2, apériodique et de même distribution.
+    stationary.cesaro_period = get_chain_period(graph, STATIONARY_MAX_PERIOD);
+    if (stationary.cesaro_period == 0) {
+        op.task.lazy = true;
+    } else if (stationary.cesaro_period > 1) {
+        int period = stationary.cesaro_period;
+        double *average = malloc(length * sizeof(double));
+        if (average == NULL) exit(EXIT_FAILURE);
+        memcpy(average, stationary.distribution, length * sizeof(double));
+
+        // Sans renormalisation intermédiaire : la moyenne reste une combinaison linéaire exacte
+        // des u P^k, même si les lignes (en float) ne somment pas exactement à 1
+        for (int k = 1; k < period && stationary.iterations < max_iterations; k++) {
+            if (apply_operator(&op, stationary.distribution, next) <= 0.0) break;
+            stationary.iterations++;
+
+            double *swap = stationary.distribution;
+            stationary.distribution = next;
+            next = swap;
+            for (int i = 0; i < length; i++) {
+                average[i] += stationary.distribution[i];
+            }
+        }
+
+        double mass = 0.0;
+        for (int i = 0; i < length; i++) {
+            mass += average[i];
+        }
+        for (int i = 0; i < length; i++) {
+            stationary.distribution[i] = average[i] / mass;
+        }
+        free(average);
+    }
+
+    while (stationary.iterations < max_iterations) {
+        // Renormalisation : compense les arrondis et la masse perdue par les états sans successeur
+        double mass = apply_operator(&op, stationary.distribution, next);
+        if (mass <= 0.0) break;
+        double residual = normalize_difference(&op, stationary.distribution, next, mass);
+
+        // L'erreur décroît asymptotiquement d'un facteur |lambda2| par itération (pour P, ou pour
+        // (I + P) / 2 sur la chaîne paresseuse). Après un départ de Cesàro, les valeurs propres de
+        // module 1 ont été moyennées : la décroissance observée ne dit rien du mélange de P.
+        if (stationary.cesaro_period <= 1 && stationary.iterations > 0 && stationary.residual > 0.0) {
+            stationary.second_eigenvalue = residual / stationary.residual;
+        }
+        stationary.residual = residual;
+        stationary.iterations++;
+
+        double *swap = stationary.distribution;
+        stationary.distribution = next;
+        next = swap;
+
+        if (stationary.residual <= tolerance) {
+            stationary.converged = true;
+            break;
+        }
+    }
+
+    // Chaîne de période d > 1 : les racines d-ièmes de l'unité sont valeurs propres, |lambda2| = 1
+    if (stationary.cesaro_period > 1) stationary.second_eigenvalue = 1.0;
+    else if (stationary.second_eigenvalue > 1.0) stationary.second_eigenvalue = 1.0;
+
+    free_operator(&op);
+    free(next);
+    return stationary;
+}
+
+#define HESSENBERG_MAX_ITERATIONS 30    // Itérations QR par valeur propre avant abandon
+
+// Décalage de Wilkinson : valeur propre du bloc 2 x 2 [[a, b], [c, d]] la plus proche de d
+static double complex wilkinson_shift(double complex a, double complex b, double complex c, double complex d) {
+    double complex mean = 0.5 * (a + d);
+    double complex root = csqrt(0.25 * (a - d) * (a - d) + b * c);
+    double complex first = mean + root, second = mean - root;
+    return cabs(first - d) <= cabs(second - d) ? first : second;
+}
+
+// Valeurs propres d'une matrice de Hessenberg supérieure k x k (ligne i, colonne j en h[i * ld + j]),
+// par itérations QR à décalage simple de Wilkinson en arithmétique complexe : une valeur propre se
+// détache en bas du bloc actif à chaque convergence, les paires conjuguées sans bloc 2 x 2 particulier.
+// Chaque itération factorise A - mu I = QR par k - 1 rotations de Givens et forme RQ + mu I (O(k^2)).
+// Retourne -1 si une valeur propre ne converge pas.
+static int hessenberg_eigenvalues(const double *h, int ld, int k, double *wr, double *wi) {
+    double complex *a = malloc((size_t) (k > 0 ? k : 1) * k * sizeof(double complex));
+    double complex *rotations = malloc(2 * (size_t) (k > 0 ? k : 1) * sizeof(double complex));
+    if (a == NULL || rotations == NULL) exit(EXIT_FAILURE);
+    for (int i = 0; i < k; i++) {
+        for (int j = 0; j < k; j++) {
+            a[i * k + j] = j >= i - 1 ? h[i * ld + j] : 0.0;
+        }
+    }
+
+    int status = 0, high = k - 1, iterations = 0;
+    while (high >= 0) {
+        // Bloc actif low..high : premier élément sous-diagonal négligeable en remontant depuis high
+        int low = high;
+        while (low > 0) {
+            double scale = cabs(a[(low - 1) * k + low - 1]) + cabs(a[low * k + low]);
+            if (cabs(a[low * k + low - 1]) <= DBL_EPSILON * scale) {
+                a[low * k + low - 1] = 0.0;
+                break;
+            }
+            low--;
+        }
+        if (low == high) {
+            wr[high] = creal(a[high * k + high]);
+            wi[high] = cimag(a[high * k + high]);
+            high--;
+            iterations = 0;
+            continue;
+        }
+        if (iterations == HESSENBERG_MAX_ITERATIONS) {
+            status = -1;
+            break;
+        }
+        iterations++;
+
+        double complex shift = wilkinson_shift(a[(high - 1) * k + high - 1], a[(high - 1) * k + high],
+                                               a[high * k + high - 1], a[high * k + high]);
+        // Décalage perturbé toutes les 10 itérations pour sortir d'un cycle du décalage de Wilkinson
+        if (iterations % 10 == 0) shift += cabs(a[high * k + high - 1]);
+
+        for (int i = low; i <= high; i++) a[i * k + i] -= shift;
+
+        // A - mu I = QR : la rotation j annule l'élément (j + 1, j)
+        for (int j = low; j < high; j++) {
+            double complex x = a[j * k + j], y = a[(j + 1) * k + j];
+            double norm = hypot(cabs(x), cabs(y));
+            double complex c = norm > 0.0 ? x / norm : 1.0, s = norm > 0.0 ? y / norm : 0.0;
+            rotations[2 * j] = c;
+            rotations[2 * j + 1] = s;
+            for (int col = j; col <= high; col++) {
+                double complex u = a[j * k + col], v = a[(j + 1) * k + col];
+                a[j * k + col] = conj(c) * u + conj(s) * v;
+                a[(j + 1) * k + col] = c * v - s * u;
+            }
+        }
+
+        // RQ : rotations adjointes appliquées à droite, la forme de Hessenberg est conservée
+        for (int j = low; j < high; j++) {
+            double complex c = rotations[2 * j], s = rotations[2 * j + 1];
+            for (int row = low; row <= j + 1; row++) {
+                double complex u = a[row * k + j], v = a[row * k + j + 1];
+                a[row * k + j] = u * c + v * s;
+                a[row * k + j + 1] = v * conj(c) - u * conj(s);
+            }
+        }
+
+        for (int i = low; i <= high; i++) a[i * k + i] += shift;
+    }
+
+    free(rotations);
+    free(a);
+    return status;
+}
+
+// Vecteur propre de h (k x k) associé à la valeur propre réelle theta, par itération inverse
+static void hessenberg_eigenvector(const double *h, int ld, int k, double theta, double *y) {
+    double *a = malloc((size_t) k * k * sizeof(double));
+    int *pivots = malloc(k * sizeof(int));
+    if (a == NULL || pivots == NULL) exit(EXIT_FAILURE);
+
+    // Léger décalage pour que h - theta I soit inversible
+    double shift = theta + 1e-10 * (fabs(theta) > 1.0 ? fabs(theta) : 1.0);
+    for (int i = 0; i < k; i++) {
+        for (int j = 0; j < k; j++) {
+            a[i * k + j] = h[i * ld + j] - (i == j ? shift : 0.0);
+        }
+    }
+
+    // Factorisation LU avec pivot partiel
+    for (int c = 0; c < k; c++) {
+        int best = c;
+        for (int i = c + 1; i < k; i++) {
+            if (fabs(a[i * k + c]) > fabs(a[best * k + c])) best = i;
+        }
+        pivots[c] = best;
+        if (best != c) {
+            for (int j = 0; j < k; j++) {
+                double swap = a[c * k + j];
+                a[c * k + j] = a[best * k + j];
+                a[best * k + j] = swap;
+            }
+        }
+        if (a[c * k + c] == 0.0) a[c * k + c] = 1e-300;
+        for (int i = c + 1; i < k; i++) {
+            double factor = a[i * k + c] /= a[c * k + c];
+            for (int j = c + 1; j < k; j++) {
+                a[i * k + j] -= factor * a[c * k + j];
+            }
+        }
+    }
+
+    for (int i = 0; i < k; i++) y[i] = 1.0;
+
+    for (int round = 0; round < 3; round++) {
+        for (int c = 0; c < k; c++) {
+            double swap = y[c];
+            y[c] = y[pivots[c]];
+            y[pivots[c]] = swap;
+        }
+        for (int i = 1; i < k; i++) {
+            for (int j = 0; j < i; j++) y[i] -= a[i * k + j] * y[j];
+        }
+        for (int i = k - 1; i >= 0; i--) {
+            for (int j = i + 1; j < k; j++) y[i] -= a[i * k + j] * y[j];
+            y[i] /= a[i * k + i];
+        }
+
+        double scale = 0.0;
+        for (int i = 0; i < k; i++) {
+            if (fabs(y[i]) > scale) scale = fabs(y[i]);
+        }
+        for (int i = 0; i < k; i++) y[i] /= scale;
+    }
+
+    free(pivots);
+    free(a);
+}
+
+// Contexte partagé des opérations sur la base de Krylov, découpées en blocs de composantes
+typedef struct s_basis_task {
+    const double *basis;            // Vecteurs v_0, ..., v_{count-1}, contigus
+    int length;                     // Nombre de composantes
+    int count;                      // Nombre de vecteurs utilisés
+    int block_count;                // Nombre de blocs
+    double *target;                 // Vecteur w
+    const double *coefficients;     // c_i (combine_task)
+    double *partial_sums;           // block_count * count sommes partielles (dots_task)
+} t_basis_task;
+
+static void basis_bounds(const t_basis_task *task, int block, int *begin, int *end) {
+    *begin = (int) ((long long) task->length * block / task->block_count);
+    *end = (int) ((long long) task->length * (block + 1) / task->block_count);
+}
+
+// Produits scalaires <w, v_i> d'un bloc
+static void dots_task(void *context, int block) {
+    t_basis_task *task = context;
+    int begin, end;
+    basis_bounds(task, block, &begin, &end);
+
+    for (int i = 0; i < task->count; i++) {
+        const double *v = task->basis + (size_t) i * task->length;
+        double sum = 0.0;
+        for (int e = begin; e < end; e++) sum += task->target[e] * v[e];
+        task->partial_sums[block * task->count + i] = sum;
+    }
+}
+
+// w -= somme des c_i v_i sur un bloc
+static void combine_task(void *context, int block) {
+    t_basis_task *task = context;
+    int begin, end;
+    basis_bounds(task, block, &begin, &end);
+
+    for (int i = 0; i < task->count; i++) {
+        const double *v = task->basis + (size_t) i * task->length;
+        double c = task->coefficients[i];
+        for (int e = begin; e < end; e++) task->target[e] -= c * v[e];
+    }
+}
+
+// dots[i] = <w, v_i> pour i < count, sommes des blocs dans l'ordre
+static void basis_dots(t_basis_task *task, t_thread_pool *pool, const double *basis, int count, double *w, double *dots) {
+    task->basis = basis;
+    task->count = count;
+    task->target = w;
+    run_parallel(pool, task->block_count, dots_task, task);
+
+    for (int i = 0; i < count; i++) {
+        dots[i] = 0.0;
+        for (int b = 0; b < task->block_count; b++) dots[i] += task->partial_sums[b * count + i];
+    }
+}
+
+static void basis_combine(t_basis_task *task, t_thread_pool *pool, const double *basis, int count, double *w, const double *coefficients) {
+    task->basis = basis;
+    task->count = count;
+    task->target = w;
+    task->coefficients = coefficients;
+    run_parallel(pool, task->block_count, combine_task, task);
+}
+
+t_stationary stationary_arnoldi(t_adj_list *graph, int krylov_dim, double tolerance, int max_iterations) {
+    int length = graph->length;
+    t_stationary stationary = create_stationary(length);
+    if (length == 0) return stationary;
+
+    int m = krylov_dim < length ? krylov_dim : length;
+    if (m < 2) m = 2;
+    int ld = m;
+
+    double *basis = malloc((size_t) (m + 1) * length * sizeof(double));
+    double *hessenberg = malloc((size_t) (m + 1) * ld * sizeof(double));
+    double *ritz = malloc(4 * (size_t) (m + 1) * sizeof(double));
+    double *next = malloc(length * sizeof(double));
+    if (basis == NULL || hessenberg == NULL || ritz == NULL || next == NULL) exit(EXIT_FAILURE);
+    double *wr = ritz, *wi = ritz + (m + 1), *coefficients = ritz + 2 * (m + 1), *dots = ritz + 3 * (m + 1);
+
+    t_spmv_operator op;
+    init_operator(&op, graph);
+    double *x = stationary.distribution;
+
+    t_basis_task basis_task;
+    basis_task.length = length;
+    basis_task.block_count = op.block_count;
+    basis_task.partial_sums = malloc((size_t) op.block_count * (m + 1) * sizeof(double));
+    if (basis_task.partial_sums == NULL) exit(EXIT_FAILURE);
+
+    while (stationary.iterations < max_iterations) {
+        // Base de Krylov orthonormée V et matrice de Hessenberg H telles que V_k^T P^T V_k = H_k
+        basis_dots(&basis_task, op.pool, x, 1, x, dots);
+        double beta = sqrt(dots[0]);
+        for (int i = 0; i < length; i++) basis[i] = x[i] / beta;
+        memset(hessenberg, 0, (size_t) (m + 1) * ld * sizeof(double));
+
+        int k = 0;
+        while (k < m && stationary.iterations < max_iterations) {
+            double *v = basis + (size_t) k * length;
+            double *w = basis + (size_t) (k + 1) * length;
+            apply_operator(&op, v, w);
+            stationary.iterations++;
+
+            // Gram-Schmidt classique, répété une fois pour conserver l'orthogonalité
+            for (int pass = 0; pass < 2; pass++) {
+                basis_dots(&basis_task, op.pool, basis, k + 1, w, dots);
+                basis_combine(&basis_task, op.pool, basis, k + 1, w, dots);
+                for (int i = 0; i <= k; i++) hessenberg[i * ld + k] += dots[i];
+            }
+
+            basis_dots(&basis_task, op.pool, w, 1, w, dots);
+            double norm = sqrt(dots[0]);
+            hessenberg[(k + 1) * ld + k] = norm;
+            k++;
+            if (norm < 1e-12) break;    // Sous-espace invariant : H_k est exacte
+            for (int e = 0; e < length; e++) w[e] /= norm;
+        }
+
+        // Valeurs de Ritz : la plus proche de 1 donne pi, la suivante en module estime |lambda2|
+        if (hessenberg_eigenvalues(hessenberg, ld, k, wr, wi) != 0) break;
+
+        int chosen = -1;
+        for (int i = 0; i < k; i++) {
+            if (fabs(wi[i]) > 1e-8) continue;
+            if (chosen < 0 || fabs(wr[i] - 1.0) < fabs(wr[chosen] - 1.0)) chosen = i;
+        }
+        if (chosen < 0) break;
+
+        // |lambda2| pris sur le dernier cycle, dont les valeurs de Ritz sont les plus précises
+        // (celles des premiers cycles peuvent dépasser le spectre, voire 1 si P n'est pas normale)
+        double second = NAN;
+        for (int i = 0; i < k; i++) {
+            if (i != chosen && (isnan(second) || hypot(wr[i], wi[i]) > second)) second = hypot(wr[i], wi[i]);
+        }
+        stationary.second_eigenvalue = isnan(second) ? NAN : fmin(second, 1.0);
+
+        // Vecteur de Ritz x = V_k y, normalisé en distribution
+        hessenberg_eigenvector(hessenberg, ld, k, wr[chosen], coefficients);
+        for (int i = 0; i < k; i++) coefficients[i] = -coefficients[i];
+        memset(x, 0, length * sizeof(double));
+        basis_combine(&basis_task, op.pool, basis, k, x, coefficients);
+        double mass = 0.0;
+        for (int e = 0; e < length; e++) mass += x[e];
+        if (mass == 0.0) break;
+        for (int e = 0; e < length; e++) x[e] /= mass;
+
+        // Résidu ||x P - x||_1 ; x P sert de vecteur de redémarrage
+        double next_mass = apply_operator(&op, x, next);
+        stationary.iterations++;
+        if (next_mass == 0.0) break;
+        stationary.residual = normalize_difference(&op, x, next, next_mass);
+
+        if (stationary.residual <= tolerance) {
+            stationary.converged = true;
+            break;
+        }
+        memcpy(x, next, length * sizeof(double));
+    }
+
+    // Une valeur propre -1 (ou racine de l'unité) échappe au sous-espace de Krylov si le départ
+    // n'a pas de composante sur son vecteur propre : les périodes des classes fermées tranchent
+    if (get_chain_period(graph, STATIONARY_MAX_PERIOD) != 1) stationary.second_eigenvalue = 1.0;
+
+    free(basis_task.partial_sums);
+    free_operator(&op);
+    free(next);
+    free(ritz);
+    free(hessenberg);
+    free(basis);
+    return stationary;
+}
+
+t_stationary stationary_gth(t_adj_list *graph) {
+    int length = graph->length;
+    t_stationary stationary = create_stationary(length);
+    if (length == 0) return stationary;
+
+    t_matrix matrix = create_matrix_from_graph(graph);
+    double *distribution = gth_stationary(matrix);
+    free_matrix(matrix);
+    if (distribution == NULL) return stationary;
+
+    free(stationary.distribution);
+    stationary.distribution = distribution;
+
+    // Résidu ||pi P - pi||_1 de la solution directe
+    double *next = malloc(length * sizeof(double));
+    if (next == NULL) exit(EXIT_FAILURE);
+    t_spmv_operator op;
+    init_operator(&op, graph);
+    double mass = apply_operator(&op, distribution, next);
+    if (mass > 0.0) {
+        stationary.residual = normalize_difference(&op, distribution, next, mass);
+        stationary.converged = true;
+    }
+    free_operator(&op);
+    free(next);
+    return stationary;
+}
+
+bool parse_stationary_method(const char *name, t_stationary_method *method) {
+    if (strcmp(name, "power") == 0) *method = STATIONARY_POWER;
+    else if (strcmp(name, "arnoldi") == 0) *method = STATIONARY_ARNOLDI;
+    else if (strcmp(name, "gth") == 0) *method = STATIONARY_GTH;
+    else return false;
+    return true;
+}
+
+t_stationary find_stationary(t_adj_list *graph, t_stationary_method method) {
+    if (method == STATIONARY_GTH) return stationary_gth(graph);
+    if (method == STATIONARY_ARNOLDI) {
+        return stationary_arnoldi(graph, STATIONARY_KRYLOV_DIM, STATIONARY_TOLERANCE, STATIONARY_MAX_ITERATIONS);
+    }
+    return stationary_power_iteration(graph, STATIONARY_TOLERANCE, STATIONARY_MAX_ITERATIONS);
+}
+
+void display_stationary(const t_stationary *stationary, int max_states) {
+    if (stationary->converged && stationary->iterations == 0) {
+        printf("Resolution directe (residu L1 %.3e).\n", stationary->residual);
+    } else if (stationary->converged) {
+        printf("Convergence en %d iterations (residu L1 %.3e).\n", stationary->iterations, stationary->residual);
+    } else {
+        printf("Pas de convergence apres %d iterations (residu L1 %.3e).\n", stationary->iterations, stationary->residual);
+    }
+    if (stationary->cesaro_period > 1) {
+        printf("Chaine de periode %d : depart moyenne de Cesaro sur une periode.\n", stationary->cesaro_period);
+    } else if (stationary->cesaro_period == 0) {
+        printf("Chaine periodique (ppcm des periodes > %d) : iteration sur la chaine paresseuse (I + P) / 2.\n", STATIONARY_MAX_PERIOD);
+    }
+    if (stationary->cesaro_period > 1) {
+        printf("|lambda2| = 1 (chaine periodique) : pas de temps de relaxation.\n");
+    } else if (!isnan(stationary->second_eigenvalue)) {
+        // Chaîne paresseuse : l'estimation porte sur (I + P) / 2, P ayant |lambda2| = 1
+        if (stationary->cesaro_period == 0) printf("|lambda2| = 1 pour P ; pour (I + P) / 2, ");
+        printf("|lambda2| estime : %.6f", stationary->second_eigenvalue);
+        if (stationary->second_eigenvalue < 1.0 - 1e-9) {
+            printf(" (temps de relaxation ~ %.1f pas)", 1.0 / (1.0 - stationary->second_eigenvalue));
+        } else {
+            printf(" : pas de temps de relaxation");
+        }
+        printf("\n");
+    }
+
+    int shown = stationary->length < max_states ? stationary->length : max_states;
+    for (int i = 0; i < shown; i++) {
+        printf("  Etat %d : %.6f\n", i + 1, stationary->distribution[i]);
+    }
+    if (shown < stationary->length) {
+        printf("  ... (%d etats)\n", stationary->length);
+    }
+}
+
+void free_stationary(t_stationary *stationary) {
+    free(stationary->distribution);
+    stationary->distribution = NULL;
+    stationary->length = 0;
+}
+
+t_class_stationary stationary_by_class(t_adj_list *graph, t_partition *partition, int *class_map, t_link_array *link_array) {
+    int length = graph->length;
+    t_class_stationary stationary;
+    stationary.length = length;
+    stationary.closed_count = 0;
+    stationary.iterations = 0;
+    stationary.residual = 0.0;
+    stationary.converged = true;
+    stationary.distribution = calloc(length > 0 ? length : 1, sizeof(double));
+    stationary.closed_classes = malloc((partition->class_count > 0 ? partition->class_count : 1) * sizeof(int));
+    // Index de chaque état dans le sous-graphe de sa classe
+    int *local_index = malloc((length > 0 ? length : 1) * sizeof(int));
+    if (stationary.distribution == NULL || stationary.closed_classes == NULL || local_index == NULL) exit(EXIT_FAILURE);
+
+    bool *is_transient = find_transient_classes(partition, link_array);
+    for (int c = 0; c < partition->class_count; c++) {
+        if (is_transient[c]) continue;
+        stationary.closed_classes[stationary.closed_count++] = c;
+        t_classe *class = &partition->classes[c];
+
+        if (class->vertex_count == 1) {
+            stationary.distribution[class->vertex_ids[0] - 1] = 1.0;
+            continue;
+        }
+
+        // Sous-graphe de la classe (identifiants à partir de 1) : toutes les arêtes de ses états y restent
+        int edge_count = 0;
+        for (int k = 0; k < class->vertex_count; k++) {
+            int v = class->vertex_ids[k] - 1;
+            local_index[v] = k;
+            edge_count += graph->offsets[v + 1] - graph->offsets[v];
+        }
+        t_edge_list edges = create_edge_list(edge_count);
+        for (int k = 0; k < class->vertex_count; k++) {
+            int v = class->vertex_ids[k] - 1;
+            for (int e = graph->offsets[v]; e < graph->offsets[v + 1]; e++) {
+                if (class_map[graph->dest[e]] == c) edge_list_add(&edges, k, local_index[graph->dest[e]], graph->proba[e]);
+            }
+        }
+        t_adj_list class_graph = build_adjlist(class->vertex_count, &edges);
+        free_edge_list(&edges);
+
+        t_stationary class_stationary = class->vertex_count <= STATIONARY_GTH_CLASS_SIZE
+            ? stationary_gth(&class_graph)
+            : stationary_power_iteration(&class_graph, STATIONARY_TOLERANCE, STATIONARY_MAX_ITERATIONS);
+        for (int k = 0; k < class->vertex_count; k++) {
+            stationary.distribution[class->vertex_ids[k] - 1] = class_stationary.distribution[k];
+        }
+        stationary.iterations += class_stationary.iterations;
+        if (class_stationary.residual > stationary.residual) stationary.residual = class_stationary.residual;
+        if (!class_stationary.converged) stationary.converged = false;
+
+        free_stationary(&class_stationary);
+        free_adjlist(&class_graph);
+    }
+
+    free(is_transient);
+    free(local_index);
+    return stationary;
+}
+
+void display_class_stationary(const t_class_stationary *stationary, t_partition *partition, int max_states) {
+    printf("%d classe(s) fermee(s), %d iteration(s) de la puissance (residu L1 max %.3e)%s.\n",
+           stationary->closed_count, stationary->iterations, stationary->residual,
+           stationary->converged ? "" : ", sans convergence");
+
+    int shown = 0, k;
+    for (k = 0; k < stationary->closed_count && shown < max_states; k++) {
+        t_classe *class = &partition->classes[stationary->closed_classes[k]];
+        printf("  Classe %s (%d etat(s)) :\n", class->name, class->vertex_count);
+        int v;
+        for (v = 0; v < class->vertex_count && shown < max_states; v++, shown++) {
+            int state = class->vertex_ids[v];
+            printf("    Etat %d : %.6f\n", state, stationary->distribution[state - 1]);
+        }
+        if (v < class->vertex_count) printf("    ...\n");
+    }
+    if (k < stationary->closed_count) printf("  ... (%d classes fermees)\n", stationary->closed_count);
+}
+
+void free_class_stationary(t_class_stationary *stationary) {
+    free(stationary->distribution);
+    free(stationary->closed_classes);
+    stationary->distribution = NULL;
+    stationary->closed_classes = NULL;
+    stationary->length = 0;
+}
@@ -0,0 +1,142 @@
+#ifndef __STATIONARY_H__
+#define __STATIONARY_H__
+
+#include "utils.h"
+#include "hasse.h"
+
+#define STATIONARY_TOLERANCE 1e-10          // Seuil par défaut sur ||pi P - pi||_1
+#define STATIONARY_MAX_ITERATIONS 100000    // Nombre maximal d'itérations par défaut
+#define STATIONARY_KRYLOV_DIM 20            // Dimension par défaut de l'espace de Krylov (Arnoldi)
+#define STATIONARY_MAX_PERIOD 1000          // Période maximale moyennée par Cesàro (chaîne paresseuse au-delà)
+#define STATIONARY_GTH_CLASS_SIZE 256       // Taille maximale d'une classe fermée résolue par GTH (puissance au-delà)
+
+// Méthode de calcul de la distribution stationnaire
+typedef enum e_stationary_method {
+    STATIONARY_POWER,               // Méthode de la puissance
+    STATIONARY_ARNOLDI,             // Arnoldi redémarré
+    STATIONARY_GTH                  // Élimination GTH directe sur la matrice dense
+} t_stationary_method;
+
+// Distribution stationnaire calculée sur le graphe creux
+typedef struct s_stationary {
+    double *distribution;       // pi[i] : probabilité stationnaire de l'état i (somme 1)
+    int length;                 // Nombre d'états
+    int iterations;             // Nombre de produits pi P effectués
+    double residual;            // ||pi P - pi||_1 à la dernière itération
+    double second_eigenvalue;   // Estimation de |lambda2| dans [0, 1] (NAN si inconnue), qui fixe la vitesse de mélange
+    int cesaro_period;          // Période moyennée au départ (1 : aucune, 0 : chaîne paresseuse)
+    bool converged;             // true si residual <= tolérance
+} t_stationary;
+
+// Distributions stationnaires des classes fermées d'une chaîne réductible : pi_j est la probabilité
+// stationnaire de j dans sa classe fermée (somme 1 sur chaque classe), 0 pour un état transitoire.
+// La matrice limite s'en déduit : L[i][j] = P(absorption de i dans la classe de j) * pi_j.
+typedef struct s_class_stationary {
+    double *distribution;       // pi_j de chaque état
+    int length;                 // Nombre d'états
+    int closed_count;           // Nombre de classes fermées
+    int *closed_classes;        // Index dans la partition de chaque classe fermée
+    int iterations;             // Nombre total de produits pi P (0 si toutes les classes sont résolues par GTH)
+    double residual;            // Plus grand résidu L1 d'une classe
+    bool converged;             // true si toutes les classes ont convergé
+} t_class_stationary;
+
+/**
+ * @brief Calcule une distribution stationnaire par la méthode de la puissance sur le graphe creux :
+ * pi <- pi P, avec des produits matrice creuse-vecteur sur le graphe transposé (O(V + E) par
+ * itération et en mémoire), en double et renormalisé à chaque pas.
+ * Départ de la distribution uniforme ; si la chaîne a plusieurs classes persistantes, le résultat
+ * est la distribution limite atteinte depuis ce départ. Si la chaîne est périodique (ppcm d des
+ * périodes des classes fermées), le départ est la moyenne de Cesàro de d itérés, qui converge ;
+ * au-delà de STATIONARY_MAX_PERIOD, l'itération porte sur la chaîne paresseuse (I + P) / 2.
+ * |lambda2| est estimé par le rapport de deux résidus successifs (sur (I + P) / 2 pour la chaîne
+ * paresseuse) ; il vaut 1 pour une chaîne périodique.
+ * @param graph Pointeur vers le graphe.
+ * @param tolerance Seuil d'arrêt sur la norme L1 de pi P - pi.
+ * @param max_iterations Nombre maximal d'itérations.
+ * @return La distribution (à libérer avec free_stationary).
+ */
+t_stationary stationary_power_iteration(t_adj_list *graph, double tolerance, int max_iterations);
+
+/**
+ * @brief Calcule la distribution stationnaire par la méthode d'Arnoldi redémarrée sur P^T :
+ * chaque cycle construit une base de Krylov de dimension krylov_dim (produits creux), prend le
+ * vecteur de Ritz de la valeur de Ritz la plus proche de 1 (itérations QR complexes à décalage de
+ * Wilkinson sur la matrice de Hessenberg) et redémarre depuis ce vecteur. La valeur de Ritz suivante en module au dernier cycle
+ * estime |lambda2| (bornée à 1, et égale à 1 si une classe fermée est périodique).
+ * Converge bien plus vite que la puissance quand |lambda2| est proche de 1 ; mémoire
+ * O((krylov_dim + 1) V + E). Destiné aux chaînes irréductibles (pi n'est pas unique sinon).
+ * @param graph Pointeur vers le graphe.
+ * @param krylov_dim Dimension de l'espace de Krylov.
+ * @param tolerance Seuil d'arrêt sur la norme L1 de pi P - pi.
+ * @param max_iterations Nombre maximal de produits pi P.
+ * @return La distribution (à libérer avec free_stationary).
+ */
+t_stationary stationary_arnoldi(t_adj_list *graph, int krylov_dim, double tolerance, int max_iterations);
+
+/**
+ * @brief Calcule la distribution stationnaire par élimination GTH sur la matrice dense du graphe
+ * (gth_stationary) : solution directe en double, pour les chaînes irréductibles de quelques
+ * milliers d'états (mémoire O(V^2)).
+ * @param graph Pointeur vers le graphe.
+ * @return La distribution (à libérer avec free_stationary) ; converged vaut false si la chaîne
+ * n'est pas irréductible.
+ */
+t_stationary stationary_gth(t_adj_list *graph);
+
+/**
+ * @brief Convertit un nom de méthode ("power", "arnoldi" ou "gth") en t_stationary_method.
+ * @param name Le nom de la méthode.
+ * @param method Pointeur vers la méthode reconnue.
+ * @return true si le nom est reconnu.
+ */
+bool parse_stationary_method(const char *name, t_stationary_method *method);
+
+/**
+ * @brief Calcule la distribution stationnaire avec la méthode demandée et les paramètres par défaut.
+ * @param graph Pointeur vers le graphe.
+ * @param method La méthode à utiliser.
+ * @return La distribution (à libérer avec free_stationary).
+ */
+t_stationary find_stationary(t_adj_list *graph, t_stationary_method method);
+
+/**
+ * @brief Calcule la distribution stationnaire de chaque classe fermée sur son sous-graphe (une
+ * classe fermée n'a pas d'arête sortante) : GTH jusqu'à STATIONARY_GTH_CLASS_SIZE états, méthode
+ * de la puissance creuse au-delà (départ de Cesàro si la classe est périodique). Mémoire O(V + E).
+ * @param graph Pointeur vers le graphe.
+ * @param partition Pointeur vers la partition en classes.
+ * @param class_map Le mappage sommet -> classe.
+ * @param link_array Pointeur vers les liens inter-classes.
+ * @return Les distributions (à libérer avec free_class_stationary).
+ */
+t_class_stationary stationary_by_class(t_adj_list *graph, t_partition *partition, int *class_map, t_link_array *link_array);
+
+/**
+ * @brief Affiche, pour chaque classe fermée, sa taille et les probabilités de ses premiers états.
+ * @param stationary Pointeur vers les distributions.
+ * @param partition Pointeur vers la partition en classes.
+ * @param max_states Nombre maximal d'états affichés (toutes classes confondues).
+ */
+void display_class_stationary(const t_class_stationary *stationary, t_partition *partition, int max_states);
+
+/**
+ * @brief Libère les distributions par classe.
+ * @param stationary Pointeur vers les distributions.
+ */
+void free_class_stationary(t_class_stationary *stationary);
+
+/**
+ * @brief Affiche le résultat du calcul et les probabilités des premiers états.
+ * @param stationary Pointeur vers la distribution.
+ * @param max_states Nombre maximal d'états affichés.
+ */
+void display_stationary(const t_stationary *stationary, int max_states);
+
+/**
+ * @brief Libère la distribution.
+ * @param stationary Pointeur vers la distribution.
+ */
+void free_stationary(t_stationary *stationary);
+
+#endif // __STATIONARY_H__
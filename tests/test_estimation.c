@@ -0,0 +1,102 @@
+#include "estimation.h"
+#include "threads.h"
+#include <math.h>
+
+#define TEST_STATES 40                  // Nombre d'états des trajectoires aléatoires
+#define TEST_SEQUENCES 200000           // Nombre de séquences (lot assez grand pour le découpage parallèle)
+#define TEST_THREADS 4                  // Threads du pool, même sur une machine mono-cœur
+
+static int failures = 0;
+
+static void check(bool condition, const char *message) {
+    if (!condition) {
+        fprintf(stderr, "Echec : %s\n", message);
+        failures++;
+    }
+}
+
+// Probabilité estimée de la transition (from, to), 0 si absente
+static double estimated(const t_adj_list *graph, int from, int to) {
+    for (int e = graph->offsets[from]; e < graph->offsets[from + 1]; e++) {
+        if (graph->dest[e] == to) return graph->proba[e];
+    }
+    return 0.0;
+}
+
+// Petit lot compté à la main : 1 -> 2 et 1 -> 3 une fois, 2 -> 1 deux fois, 2 -> 2 une fois, 3 jamais quitté
+static void test_hand_counted(void) {
+    const char *data = "1 2 1 3\n\n2,2 1\n";
+    t_estimator estimator = create_estimator(0);
+    long line = 1;
+    t_parse_error error;
+    check(estimator_add_buffer(&estimator, data, data + strlen(data), &line, &error) == 0, "lot valide refuse");
+    t_adj_list graph = estimate_graph(&estimator);
+
+    check(graph.length == 3, "nombre d'etats");
+    check(estimator.sequences == 2 && estimator.transitions == 5, "sequences et transitions");
+    check(fabs(estimated(&graph, 0, 1) - 0.5) < 1e-6 && fabs(estimated(&graph, 0, 2) - 0.5) < 1e-6, "ligne 1");
+    check(fabs(estimated(&graph, 1, 0) - 2.0 / 3.0) < 1e-6 && fabs(estimated(&graph, 1, 1) - 1.0 / 3.0) < 1e-6, "ligne 2");
+    check(estimated(&graph, 2, 2) == 1.0 && estimator.unobserved_states == 1, "etat jamais quitte");
+
+    free_adjlist(&graph);
+    free_estimator(&estimator);
+}
+
+// Grand lot aléatoire, lu comme un flux, comparé à un comptage direct ; un second flux invalide
+// en fin de fichier ne doit rien changer
+static void test_random_stream(void) {
+    static long long counts[TEST_STATES][TEST_STATES];
+    FILE *stream = tmpfile();
+    FILE *invalid = tmpfile();
+    if (stream == NULL || invalid == NULL) exit(EXIT_FAILURE);
+
+    srand(3000);
+    for (int s = 0; s < TEST_SEQUENCES; s++) {
+        int length = 1 + rand() % 8, previous = -1;
+        for (int t = 0; t < length; t++) {
+            int state = rand() % TEST_STATES;
+            if (previous >= 0) counts[previous][state]++;
+            fprintf(stream, t == 0 ? "%d" : " %d", state + 1);
+            fprintf(invalid, t == 0 ? "%d" : " %d", state + 1);
+            previous = state;
+        }
+        fputc('\n', stream);
+        fputc('\n', invalid);
+    }
+    fprintf(invalid, "1 x\n");
+    rewind(stream);
+    rewind(invalid);
+
+    t_estimator estimator = create_estimator(TEST_STATES);
+    t_parse_error error;
+    check(estimator_add_stream(&estimator, stream, &error) == 0, "flux valide refuse");
+    long long transitions = estimator.transitions;
+    check(estimator_add_stream(&estimator, invalid, &error) != 0, "flux invalide accepte");
+    check(estimator.transitions == transitions && estimator.sequences == TEST_SEQUENCES, "flux invalide compte");
+
+    t_adj_list graph = estimate_graph(&estimator);
+    double worst = 0.0;
+    for (int i = 0; i < TEST_STATES; i++) {
+        long long total = 0;
+        for (int j = 0; j < TEST_STATES; j++) total += counts[i][j];
+        for (int j = 0; j < TEST_STATES && total > 0; j++) {
+            double difference = fabs(estimated(&graph, i, j) - (double) counts[i][j] / total);
+            if (difference > worst) worst = difference;
+        }
+    }
+    check(worst < 1e-6, "frequences differentes du comptage direct");
+
+    free_adjlist(&graph);
+    free_estimator(&estimator);
+    fclose(stream);
+    fclose(invalid);
+}
+
+int main(void) {
+    set_thread_count(TEST_THREADS);
+    test_hand_counted();
+    test_random_stream();
+    free_global_thread_pool();
+    printf("%d echec(s).\n", failures);
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
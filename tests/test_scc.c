@@ -0,0 +1,69 @@
+#include "scc.h"
+#include "threads.h"
+
+#define TEST_GRAPHS 20                  // Nombre de graphes aléatoires
+#define TEST_VERTICES 100000            // Sommets par graphe (au-delà de PARALLEL_THRESHOLD)
+#define TEST_THREADS 4                  // Threads du pool, même sur une machine mono-cœur
+
+// Graphe aléatoire : petits cycles (classes de quelques sommets), un grand cycle sur une partie
+// des sommets (grande classe) et des arêtes aléatoires qui relient ou fusionnent des classes
+static t_adj_list random_graph(int length, unsigned int seed) {
+    srand(seed);
+    t_edge_list edges = create_edge_list(4 * length);
+    int v = 0;
+    while (v < length) {
+        int size = 1 + rand() % 5;
+        if (v + size > length) size = length - v;
+        for (int k = 0; k < size; k++) {
+            edge_list_add(&edges, v + k, v + (k + 1) % size, 0.5f);
+        }
+        v += size;
+    }
+    int big = length / (2 + rand() % 4);
+    for (int k = 0; k < big; k++) {
+        edge_list_add(&edges, k * 2 % length, (k + 1) * 2 % length, 0.25f);
+    }
+    for (int e = 0; e < length / 2; e++) {
+        edge_list_add(&edges, rand() % length, rand() % length, 0.25f);
+    }
+    t_adj_list graph = build_adjlist(length, &edges);
+    free_edge_list(&edges);
+    return graph;
+}
+
+// 0 si les deux partitions sont identiques (mêmes classes, mêmes sommets, mêmes noms, même ordre)
+static int compare_partitions(const t_partition *a, const t_partition *b) {
+    if (a->class_count != b->class_count) return -1;
+    for (int c = 0; c < a->class_count; c++) {
+        const t_classe *x = &a->classes[c], *y = &b->classes[c];
+        if (x->vertex_count != y->vertex_count || strcmp(x->name, y->name) != 0) return -1;
+        for (int k = 0; k < x->vertex_count; k++) {
+            if (x->vertex_ids[k] != y->vertex_ids[k]) return -1;
+        }
+    }
+    return 0;
+}
+
+int main(void) {
+    set_thread_count(TEST_THREADS);
+    int failures = 0;
+
+    for (int g = 0; g < TEST_GRAPHS; g++) {
+        t_adj_list graph = random_graph(TEST_VERTICES, 1000 + g);
+        t_partition sequential = find_scc(&graph, SCC_TARJAN);
+        t_partition parallel = find_scc(&graph, SCC_PARALLEL);
+
+        if (compare_partitions(&sequential, &parallel) != 0) {
+            fprintf(stderr, "Graphe %d : partitions differentes (%d classes avec tarjan, %d en parallele).\n",
+                    g, sequential.class_count, parallel.class_count);
+            failures++;
+        }
+        free_partition(&sequential);
+        free_partition(&parallel);
+        free_adjlist(&graph);
+    }
+
+    free_global_thread_pool();
+    printf("%d graphe(s), %d echec(s).\n", TEST_GRAPHS, failures);
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
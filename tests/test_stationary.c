@@ -0,0 +1,69 @@
+#include "stationary.h"
+#include "threads.h"
+#include <math.h>
+
+#define TEST_GRAPHS 20                  // Nombre de chaînes aléatoires
+#define TEST_MAX_VERTICES 300           // Nombre maximal d'états (GTH dense)
+#define TEST_TOLERANCE 1e-5             // Écart maximal toléré (probabilités stockées en float)
+
+// Chaîne irréductible et apériodique : anneau, boucles et arêtes aléatoires, lignes normalisées
+static t_adj_list random_chain(int length, unsigned int seed) {
+    srand(seed);
+    t_edge_list edges = create_edge_list(4 * length);
+    for (int i = 0; i < length; i++) {
+        int targets[3] = { (i + 1) % length, i, rand() % length };
+        float weights[3], total = 0.0f;
+        for (int k = 0; k < 3; k++) {
+            weights[k] = (float) (1 + rand() % 100);
+            total += weights[k];
+        }
+        // La cible aléatoire peut coïncider avec l'anneau ou la boucle : son poids y est ajouté
+        if (targets[2] == targets[0]) weights[0] += weights[2];
+        else if (targets[2] == targets[1]) weights[1] += weights[2];
+        int count = targets[2] == targets[0] || targets[2] == targets[1] ? 2 : 3;
+        for (int k = 0; k < count; k++) {
+            edge_list_add(&edges, i, targets[k], weights[k] / total);
+        }
+    }
+    t_adj_list graph = build_adjlist(length, &edges);
+    free_edge_list(&edges);
+    return graph;
+}
+
+static double max_difference(const t_stationary *a, const t_stationary *b) {
+    double worst = 0.0;
+    for (int i = 0; i < a->length; i++) {
+        double difference = fabs(a->distribution[i] - b->distribution[i]);
+        if (difference > worst) worst = difference;
+    }
+    return worst;
+}
+
+int main(void) {
+    int failures = 0;
+
+    for (int g = 0; g < TEST_GRAPHS; g++) {
+        int length = 2 + (g * 37) % (TEST_MAX_VERTICES - 1);
+        t_adj_list graph = random_chain(length, 2000 + g);
+        t_stationary direct = stationary_gth(&graph);
+        t_stationary power = stationary_power_iteration(&graph, STATIONARY_TOLERANCE, STATIONARY_MAX_ITERATIONS);
+        t_stationary arnoldi = stationary_arnoldi(&graph, STATIONARY_KRYLOV_DIM, STATIONARY_TOLERANCE, STATIONARY_MAX_ITERATIONS);
+
+        double power_error = max_difference(&direct, &power);
+        double arnoldi_error = max_difference(&direct, &arnoldi);
+        if (!direct.converged || !power.converged || !arnoldi.converged
+            || power_error > TEST_TOLERANCE || arnoldi_error > TEST_TOLERANCE) {
+            fprintf(stderr, "Chaine %d (%d etats) : ecart GTH / puissance %.3e, GTH / Arnoldi %.3e.\n",
+                    g, length, power_error, arnoldi_error);
+            failures++;
+        }
+        free_stationary(&direct);
+        free_stationary(&power);
+        free_stationary(&arnoldi);
+        free_adjlist(&graph);
+    }
+
+    free_global_thread_pool();
+    printf("%d chaine(s), %d echec(s).\n", TEST_GRAPHS, failures);
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
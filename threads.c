@@ -0,0 +1,151 @@
+#include "threads.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+static t_thread_pool *global_pool = NULL;
+
+int default_thread_count(void) {
+    const char *requested = getenv("MARKOV_THREADS");
+    if (requested != NULL && atoi(requested) > 0) return atoi(requested);
+
+#ifdef _WIN32
+    const char *processors = getenv("NUMBER_OF_PROCESSORS");
+    int count = processors != NULL ? atoi(processors) : 1;
+#else
+    int count = (int) sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    return count > 0 ? count : 1;
+}
+
+// Prend la prochaine tâche du lot et l'exécute ; retourne false si le lot est épuisé.
+// Appelée avec le verrou pris, le rend pris.
+static bool run_next_task(t_thread_pool *pool) {
+    if (pool->next_task >= pool->task_count) return false;
+
+    int task_index = pool->next_task++;
+    t_task task = pool->task;
+    void *context = pool->context;
+
+    pthread_mutex_unlock(&pool->lock);
+    task(context, task_index);
+    pthread_mutex_lock(&pool->lock);
+
+    pool->finished_tasks++;
+    if (pool->finished_tasks == pool->task_count) {
+        pthread_cond_signal(&pool->work_done);
+    }
+    return true;
+}
+
+static void *worker_loop(void *argument) {
+    t_thread_pool *pool = argument;
+
+    pthread_mutex_lock(&pool->lock);
+    while (!pool->stopping) {
+        if (!run_next_task(pool)) {
+            pthread_cond_wait(&pool->work_ready, &pool->lock);
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+t_thread_pool *create_thread_pool(int thread_count) {
+    t_thread_pool *pool = malloc(sizeof(t_thread_pool));
+    if (pool == NULL) exit(EXIT_FAILURE);
+
+    if (thread_count < 1) thread_count = 1;
+    pool->thread_count = thread_count;
+    pool->task = NULL;
+    pool->context = NULL;
+    pool->task_count = 0;
+    pool->next_task = 0;
+    pool->finished_tasks = 0;
+    pool->stopping = false;
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->work_ready, NULL);
+    pthread_cond_init(&pool->work_done, NULL);
+
+    pool->workers = malloc((thread_count > 1 ? thread_count - 1 : 1) * sizeof(pthread_t));
+    if (pool->workers == NULL) exit(EXIT_FAILURE);
+
+    for (int i = 0; i < thread_count - 1; i++) {
+        if (pthread_create(&pool->workers[i], NULL, worker_loop, pool) != 0) {
+            perror("Creation d'un thread impossible");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    return pool;
+}
+
+void run_parallel(t_thread_pool *pool, int task_count, t_task task, void *context) {
+    if (task_count <= 0) return;
+
+    if (pool == NULL || pool->thread_count == 1 || task_count == 1) {
+        for (int i = 0; i < task_count; i++) {
+            task(context, i);
+        }
+        return;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->task = task;
+    pool->context = context;
+    pool->task_count = task_count;
+    pool->next_task = 0;
+    pool->finished_tasks = 0;
+    pthread_cond_broadcast(&pool->work_ready);
+
+    while (run_next_task(pool)) {
+    }
+    while (pool->finished_tasks < pool->task_count) {
+        pthread_cond_wait(&pool->work_done, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
+
+void free_thread_pool(t_thread_pool *pool) {
+    if (pool == NULL) return;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->stopping = true;
+    pthread_cond_broadcast(&pool->work_ready);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (int i = 0; i < pool->thread_count - 1; i++) {
+        pthread_join(pool->workers[i], NULL);
+    }
+
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->work_ready);
+    pthread_cond_destroy(&pool->work_done);
+    free(pool->workers);
+    free(pool);
+}
+
+t_thread_pool *get_thread_pool(void) {
+    if (global_pool == NULL) {
+        global_pool = create_thread_pool(default_thread_count());
+    }
+    return global_pool;
+}
+
+void set_thread_count(int thread_count) {
+    free_thread_pool(global_pool);
+    global_pool = create_thread_pool(thread_count);
+}
+
+t_thread_pool *pool_for_work(long work) {
+    if (work < PARALLEL_THRESHOLD) return NULL;
+    return get_thread_pool();
+}
+
+void free_global_thread_pool(void) {
+    free_thread_pool(global_pool);
+    global_pool = NULL;
+}
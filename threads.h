@@ -0,0 +1,83 @@
+#ifndef __THREADS_H__
+#define __THREADS_H__
+
+#include <pthread.h>
+#include <stdbool.h>
+
+// En dessous de ce volume de travail (nombre d'éléments), les noyaux restent séquentiels
+#define PARALLEL_THRESHOLD 65536
+
+// Tâche exécutée par le pool : reçoit le contexte partagé et l'index de la tâche
+typedef void (*t_task)(void *context, int task_index);
+
+// Pool de threads persistant : les workers attendent un lot de tâches puis se rendorment
+typedef struct s_thread_pool {
+    int thread_count;               // Nombre de threads de calcul (thread appelant compris)
+    pthread_t *workers;             // Threads secondaires (thread_count - 1)
+    pthread_mutex_t lock;           // Protège les champs ci-dessous
+    pthread_cond_t work_ready;      // Signalé quand un nouveau lot est disponible
+    pthread_cond_t work_done;       // Signalé quand la dernière tâche du lot est terminée
+    t_task task;                    // Fonction du lot en cours
+    void *context;                  // Contexte du lot en cours
+    int task_count;                 // Nombre de tâches du lot
+    int next_task;                  // Prochaine tâche à distribuer
+    int finished_tasks;             // Nombre de tâches terminées
+    bool stopping;                  // Demande d'arrêt des workers
+} t_thread_pool;
+
+/**
+ * @brief Donne le nombre de threads par défaut : la variable d'environnement
+ * MARKOV_THREADS si elle est définie, sinon le nombre de cœurs en ligne.
+ * @return Le nombre de threads, au moins 1.
+ */
+int default_thread_count(void);
+
+/**
+ * @brief Crée un pool de threads persistant.
+ * @param thread_count Nombre de threads de calcul, thread appelant compris.
+ * @return Le pool alloué.
+ */
+t_thread_pool *create_thread_pool(int thread_count);
+
+/**
+ * @brief Exécute task(context, i) pour i de 0 à task_count - 1 et attend la fin du lot.
+ * Le thread appelant participe au calcul. Un pool NULL exécute les tâches séquentiellement.
+ * Les appels imbriqués (depuis une tâche) ne sont pas autorisés.
+ * @param pool Le pool à utiliser (ou NULL).
+ * @param task_count Nombre de tâches.
+ * @param task La fonction à exécuter.
+ * @param context Le contexte partagé passé à chaque tâche.
+ */
+void run_parallel(t_thread_pool *pool, int task_count, t_task task, void *context);
+
+/**
+ * @brief Arrête les workers et libère le pool.
+ * @param pool Le pool à libérer.
+ */
+void free_thread_pool(t_thread_pool *pool);
+
+/**
+ * @brief Donne le pool partagé du programme, créé au premier appel.
+ * @return Le pool partagé.
+ */
+t_thread_pool *get_thread_pool(void);
+
+/**
+ * @brief Fixe le nombre de threads du pool partagé (le pool existant est recréé).
+ * @param thread_count Nombre de threads de calcul, thread appelant compris.
+ */
+void set_thread_count(int thread_count);
+
+/**
+ * @brief Donne le pool partagé si le volume de travail justifie la parallélisation.
+ * @param work Volume de travail (nombre de sommets, d'arêtes, de cases...).
+ * @return Le pool partagé, ou NULL pour une exécution séquentielle.
+ */
+t_thread_pool *pool_for_work(long work);
+
+/**
+ * @brief Libère le pool partagé (à appeler en fin de programme).
+ */
+void free_global_thread_pool(void);
+
+#endif // __THREADS_H__
@@ -1,4 +1,7 @@
 #include "utils.h"
+#include "parser.h"
+#include "threads.h"
+#include <limits.h>
 
 char *getID(int i) {
     char *buffer = malloc(10 * sizeof(char));
@@ -19,45 +22,52 @@ char *getID(int i) {
     return buffer;
 }
 
-t_cell *create_cell(int dest, float proba){
-    t_cell *new_cell;
-    new_cell = (t_cell *) malloc(sizeof(t_cell));
-    new_cell->dest = dest;
-    new_cell->proba = proba;
-    new_cell->next = NULL;
-    return new_cell;
-}
+t_edge_list create_edge_list(int initial_capacity) {
+    t_edge_list edges;
+    if (initial_capacity < 1) initial_capacity = 1;
+
+    edges.count = 0;
+    edges.capacity = initial_capacity;
+    edges.from = malloc(initial_capacity * sizeof(int));
+    edges.dest = malloc(initial_capacity * sizeof(int));
+    edges.proba = malloc(initial_capacity * sizeof(float));
+    if (edges.from == NULL || edges.dest == NULL || edges.proba == NULL) exit(EXIT_FAILURE);
 
-t_list create_empty_list(){
-    t_list list;
-    list.head = NULL;
-    return list;
+    return edges;
 }
 
-void list_add_front(t_list *L, int dest, float proba){
-    t_cell *new_cell = create_cell(dest, proba);
-    new_cell->next = L->head;
-    L->head = new_cell;
-   return;
+void edge_list_add(t_edge_list *edges, int from, int dest, float proba) {
+    if (edges->count >= edges->capacity) {
+        edges->capacity *= 2;
+        edges->from = realloc(edges->from, edges->capacity * sizeof(int));
+        edges->dest = realloc(edges->dest, edges->capacity * sizeof(int));
+        edges->proba = realloc(edges->proba, edges->capacity * sizeof(float));
+        if (edges->from == NULL || edges->dest == NULL || edges->proba == NULL) exit(EXIT_FAILURE);
+    }
+
+    edges->from[edges->count] = from;
+    edges->dest[edges->count] = dest;
+    edges->proba[edges->count] = proba;
+    edges->count++;
 }
 
-void display_list(t_list L) {
-   t_cell *curr;
-   curr = L.head;
+void free_edge_list(t_edge_list *edges) {
+    free(edges->from);
+    free(edges->dest);
+    free(edges->proba);
+    edges->from = edges->dest = NULL;
+    edges->proba = NULL;
+    edges->count = edges->capacity = 0;
+}
 
+void display_list(t_adj_list adj_list, int vertex) {
    printf("[head @] ");
-   
-   if (curr == NULL){
-        return;
-    }
 
-   while (curr != NULL) {   
-        if (curr == L.head) {
-            printf(" -> (%d , %.2f) ", curr->dest+1, curr->proba);
-            curr = curr->next;
+   for (int e = adj_list.offsets[vertex]; e < adj_list.offsets[vertex + 1]; e++) {
+        if (e == adj_list.offsets[vertex]) {
+            printf(" -> (%d , %.2f) ", adj_list.dest[e]+1, adj_list.proba[e]);
         } else {
-            printf(" @ -> (%d , %.2f) ", curr->dest+1, curr->proba);
-            curr = curr->next;
+            printf(" @ -> (%d , %.2f) ", adj_list.dest[e]+1, adj_list.proba[e]);
         }
    }
 }
@@ -65,60 +75,352 @@ void display_list(t_list L) {
 t_adj_list create_empty_adjlist(int length){
     t_adj_list adj_list;
     adj_list.length = length;
-    adj_list.list = malloc(length * sizeof(t_list));
+    adj_list.edge_count = 0;
+    adj_list.offsets = calloc(length + 1, sizeof(int));
+    adj_list.dest = NULL;
+    adj_list.proba = NULL;
+    adj_list.storage = NULL;
+    if (adj_list.offsets == NULL) exit(EXIT_FAILURE);
+
+    return adj_list;
+}
+
+// Contexte partagé par les étapes du tri par comptage parallèle
+typedef struct s_build_context {
+    t_adj_list *adj_list;           // Graphe en construction
+    t_edge_list *parts;             // Tableaux d'arêtes, dans l'ordre du fichier
+    int part_count;                 // Nombre de tableaux
+    int **counts;                   // counts[t][v] : degré de v dans le tableau t, puis curseur d'écriture
+    int block_count;                // Nombre de blocs de sommets
+    long long *block_sums;          // Nombre d'arêtes par bloc, puis offset de début du bloc
+} t_build_context;
+
+static void block_bounds(int length, int block_count, int block, int *begin, int *end) {
+    *begin = (int) ((long long) length * block / block_count);
+    *end = (int) ((long long) length * (block + 1) / block_count);
+}
+
+static void count_part_task(void *context, int part) {
+    t_build_context *ctx = context;
+    t_edge_list *edges = &ctx->parts[part];
+    int *counts = ctx->counts[part];
+
+    for (int e = 0; e < edges->count; e++) {
+        counts[edges->from[e]]++;
+    }
+}
+
+static void sum_block_task(void *context, int block) {
+    t_build_context *ctx = context;
+    int begin, end;
+    long long block_sum = 0;
+    block_bounds(ctx->adj_list->length, ctx->block_count, block, &begin, &end);
+
+    for (int v = begin; v < end; v++) {
+        int degree = 0;
+        for (int t = 0; t < ctx->part_count; t++) {
+            degree += ctx->counts[t][v];
+        }
+        ctx->adj_list->offsets[v + 1] = degree;
+        block_sum += degree;
+    }
+    ctx->block_sums[block] = block_sum;
+}
+
+static void prefix_block_task(void *context, int block) {
+    t_build_context *ctx = context;
+    int begin, end;
+    int running = (int) ctx->block_sums[block];
+    block_bounds(ctx->adj_list->length, ctx->block_count, block, &begin, &end);
+
+    for (int v = begin; v < end; v++) {
+        int cursor = running;
+        for (int t = 0; t < ctx->part_count; t++) {
+            int count = ctx->counts[t][v];
+            ctx->counts[t][v] = cursor;
+            cursor += count;
+        }
+        running += ctx->adj_list->offsets[v + 1];
+        ctx->adj_list->offsets[v + 1] = running;
+    }
+}
 
-    for (int i = 0; i < length; i++) {
-        adj_list.list[i] = create_empty_list();
+static void scatter_part_task(void *context, int part) {
+    t_build_context *ctx = context;
+    t_edge_list *edges = &ctx->parts[part];
+    int *cursor = ctx->counts[part];
+
+    for (int e = 0; e < edges->count; e++) {
+        int pos = cursor[edges->from[e]]++;
+        ctx->adj_list->dest[pos] = edges->dest[e];
+        ctx->adj_list->proba[pos] = edges->proba[e];
+    }
+}
+
+t_adj_list build_adjlist_parts(int length, t_edge_list *parts, int part_count) {
+    long long edge_count = 0;
+    for (int t = 0; t < part_count; t++) {
+        edge_count += parts[t].count;
+    }
+    if (edge_count > INT_MAX) {
+        fprintf(stderr, "Trop d'aretes (%lld).\n", edge_count);
+        exit(EXIT_FAILURE);
+    }
+
+    t_adj_list adj_list = create_empty_adjlist(length);
+    adj_list.edge_count = (int) edge_count;
+    adj_list.dest = malloc((edge_count > 0 ? edge_count : 1) * sizeof(int));
+    adj_list.proba = malloc((edge_count > 0 ? edge_count : 1) * sizeof(float));
+    if (adj_list.dest == NULL || adj_list.proba == NULL) exit(EXIT_FAILURE);
+
+    t_thread_pool *pool = pool_for_work(length + edge_count);
+
+    t_build_context ctx;
+    ctx.adj_list = &adj_list;
+    ctx.parts = parts;
+    ctx.part_count = part_count;
+    ctx.block_count = pool != NULL ? pool->thread_count * 4 : 1;
+    if (ctx.block_count > length) ctx.block_count = length > 0 ? length : 1;
+    ctx.counts = malloc(part_count * sizeof(int *));
+    ctx.block_sums = malloc(ctx.block_count * sizeof(long long));
+    if (ctx.counts == NULL || ctx.block_sums == NULL) exit(EXIT_FAILURE);
+
+    for (int t = 0; t < part_count; t++) {
+        ctx.counts[t] = calloc(length > 0 ? length : 1, sizeof(int));
+        if (ctx.counts[t] == NULL) exit(EXIT_FAILURE);
+    }
+
+    // 1. Degrés par tableau, 2. degrés totaux par bloc de sommets,
+    // 3. offsets des blocs, 4. offsets des sommets et curseurs par tableau, 5. placement
+    run_parallel(pool, part_count, count_part_task, &ctx);
+    run_parallel(pool, ctx.block_count, sum_block_task, &ctx);
+
+    long long running = 0;
+    for (int b = 0; b < ctx.block_count; b++) {
+        long long block_sum = ctx.block_sums[b];
+        ctx.block_sums[b] = running;
+        running += block_sum;
     }
 
+    run_parallel(pool, ctx.block_count, prefix_block_task, &ctx);
+    run_parallel(pool, part_count, scatter_part_task, &ctx);
+
+    for (int t = 0; t < part_count; t++) {
+        free(ctx.counts[t]);
+    }
+    free(ctx.counts);
+    free(ctx.block_sums);
     return adj_list;
 }
 
+t_adj_list build_adjlist(int length, t_edge_list *edges) {
+    return build_adjlist_parts(length, edges, 1);
+}
+
+void free_adjlist(t_adj_list *adj_list) {
+    if (adj_list->storage != NULL) {
+        unmap_file(adj_list->storage);
+        free(adj_list->storage);
+        adj_list->storage = NULL;
+    } else {
+        free(adj_list->offsets);
+        free(adj_list->dest);
+        free(adj_list->proba);
+    }
+    adj_list->offsets = adj_list->dest = NULL;
+    adj_list->proba = NULL;
+    adj_list->length = adj_list->edge_count = 0;
+}
+
+// Contexte du remplissage parallèle du tableau des sommets de départ
+typedef struct s_sources_context {
+    t_adj_list *graph;
+    int *sources;
+    int block_count;
+} t_sources_context;
+
+static void fill_sources_task(void *context, int block) {
+    t_sources_context *ctx = context;
+    int begin, end;
+    block_bounds(ctx->graph->length, ctx->block_count, block, &begin, &end);
+
+    for (int v = begin; v < end; v++) {
+        for (int e = ctx->graph->offsets[v]; e < ctx->graph->offsets[v + 1]; e++) {
+            ctx->sources[e] = v;
+        }
+    }
+}
+
+int *balanced_blocks(const t_adj_list *graph, int block_count) {
+    int *block_starts = malloc((block_count + 1) * sizeof(int));
+    if (block_starts == NULL) exit(EXIT_FAILURE);
+
+    long long total = (long long) graph->length + graph->edge_count;
+    block_starts[0] = 0;
+    block_starts[block_count] = graph->length;
+
+    for (int b = 1; b < block_count; b++) {
+        long long target = total * b / block_count;
+        int low = block_starts[b - 1], high = graph->length;
+
+        // Premier sommet v tel que v + offsets[v] >= target
+        while (low < high) {
+            int mid = low + (high - low) / 2;
+            if (mid + (long long) graph->offsets[mid] < target) low = mid + 1;
+            else high = mid;
+        }
+        block_starts[b] = low;
+    }
+    return block_starts;
+}
+
+t_adj_list transpose_adjlist(t_adj_list *graph) {
+    int *sources = malloc((graph->edge_count > 0 ? graph->edge_count : 1) * sizeof(int));
+    if (sources == NULL) exit(EXIT_FAILURE);
+
+    t_thread_pool *pool = pool_for_work(graph->length + (long) graph->edge_count);
+    int part_count = pool != NULL ? pool->thread_count : 1;
+    if (part_count > graph->length) part_count = graph->length > 0 ? graph->length : 1;
+
+    t_sources_context ctx = { graph, sources, part_count };
+    run_parallel(pool, part_count, fill_sources_task, &ctx);
+
+    // Chaque tranche d'arêtes est vue comme un tableau (dest -> source), sans copie
+    t_edge_list *parts = malloc(part_count * sizeof(t_edge_list));
+    if (parts == NULL) exit(EXIT_FAILURE);
+
+    for (int t = 0; t < part_count; t++) {
+        int begin = (int) ((long long) graph->edge_count * t / part_count);
+        int end = (int) ((long long) graph->edge_count * (t + 1) / part_count);
+        parts[t].count = end - begin;
+        parts[t].capacity = end - begin;
+        parts[t].from = graph->dest + begin;
+        parts[t].dest = sources + begin;
+        parts[t].proba = graph->proba + begin;
+    }
+
+    t_adj_list reverse = build_adjlist_parts(graph->length, parts, part_count);
+
+    free(parts);
+    free(sources);
+    return reverse;
+}
+
+static void exit_on_parse_error(const char *filename, t_mapped_file *file, t_parse_error *error) {
+    fprintf(stderr, "%s, ligne %ld : %s\n", filename, error->line, error->message);
+    unmap_file(file);
+    exit(EXIT_FAILURE);
+}
+
+// Morceau du fichier analysé par un thread
+typedef struct s_chunk {
+    const char *begin;              // Début du morceau (début de ligne)
+    const char *end;                // Fin du morceau (après un '\n' ou fin du fichier)
+    t_edge_list edges;              // Arêtes lues dans ce morceau
+    long lines;                     // Nombre de lignes parcourues
+    int status;                     // 0 si succès, -1 si erreur
+    t_parse_error error;            // Erreur (numéro de ligne relatif au morceau)
+} t_chunk;
+
+typedef struct s_parse_context {
+    t_chunk *chunks;
+    int nbvert;
+} t_parse_context;
+
+static void parse_chunk_task(void *context, int chunk_index) {
+    t_parse_context *ctx = context;
+    t_chunk *chunk = &ctx->chunks[chunk_index];
+
+    long max_edges = count_lines(chunk->begin, chunk->end) + 1;
+    if (max_edges > INT_MAX) max_edges = INT_MAX;
+
+    chunk->edges = create_edge_list((int) max_edges);
+    chunk->lines = 0;
+    chunk->status = parse_edges(chunk->begin, chunk->end, ctx->nbvert, &chunk->edges, &chunk->lines, &chunk->error);
+}
+
 t_adj_list read_graph(const char *filename) {
- 
-    FILE* file = fopen(filename, "rt");
-    int nbvert, depart, arrivee;
-    float proba;
- 
-    if (file == NULL) {
- 
+    t_mapped_file file;
+    t_parse_error error;
+    int nbvert;
+    long line = 1;
+
+    if (map_file(filename, &file) != 0) {
         perror("Le fichier n'a pas pu etre ouvert");
         exit(EXIT_FAILURE);
     }
- 
-    if (fscanf(file, "%d", &nbvert) != 1) {
- 
-        perror("Erreur de lecture du nombre de sommets");
-        fclose(file);
+
+    const char *end = file.data + file.size;
+    const char *body = parse_header(file.data, end, &nbvert, &line, &error);
+    if (body == NULL) exit_on_parse_error(filename, &file, &error);
+
+    // Découpage en morceaux alignés sur les fins de ligne, un par thread ;
+    // chaque morceau est dimensionné à une arête par ligne, sans réallocation
+    t_thread_pool *pool = pool_for_work((long) ((end - body) / 16));
+    int chunk_count = pool != NULL ? pool->thread_count : 1;
+
+    t_chunk *chunks = malloc(chunk_count * sizeof(t_chunk));
+    if (chunks == NULL) exit(EXIT_FAILURE);
+
+    const char *chunk_begin = body;
+    for (int c = 0; c < chunk_count; c++) {
+        const char *chunk_end = body + (end - body) * (c + 1) / chunk_count;
+        if (chunk_end < chunk_begin) chunk_end = chunk_begin;
+        if (c == chunk_count - 1) chunk_end = end;
+
+        const char *newline = chunk_end < end ? memchr(chunk_end, '\n', end - chunk_end) : NULL;
+        if (c < chunk_count - 1) chunk_end = newline != NULL ? newline + 1 : end;
+
+        chunks[c].begin = chunk_begin;
+        chunks[c].end = chunk_end;
+        chunk_begin = chunk_end;
+    }
+
+    t_parse_context ctx = { chunks, nbvert };
+    run_parallel(pool, chunk_count, parse_chunk_task, &ctx);
+    unmap_file(&file);
+
+    // Le numéro de ligne d'une erreur est relatif à son morceau : on y ajoute les lignes des morceaux précédents
+    int failed_chunk = -1;
+    for (int c = 0; c < chunk_count && failed_chunk == -1; c++) {
+        if (chunks[c].status != 0) {
+            failed_chunk = c;
+            chunks[c].error.line += line;
+        } else {
+            line += chunks[c].lines;
+        }
+    }
+
+    t_edge_list *parts = malloc(chunk_count * sizeof(t_edge_list));
+    if (parts == NULL) exit(EXIT_FAILURE);
+    for (int c = 0; c < chunk_count; c++) {
+        parts[c] = chunks[c].edges;
+    }
+
+    if (failed_chunk != -1) {
+        fprintf(stderr, "%s, ligne %ld : %s\n", filename, chunks[failed_chunk].error.line, chunks[failed_chunk].error.message);
         exit(EXIT_FAILURE);
     }
- 
-    t_adj_list adj_list = create_empty_adjlist(nbvert);
- 
-    while (fscanf(file, "%d %d %f", &depart, &arrivee, &proba) == 3) {
- 
-        depart -= 1;
-        arrivee -= 1;
- 
-        t_cell *new_cell = create_cell(arrivee, proba);
- 
-        new_cell->next = adj_list.list[depart].head;
-        adj_list.list[depart].head = new_cell;
+
+    t_adj_list adj_list = build_adjlist_parts(nbvert, parts, chunk_count);
+
+    for (int c = 0; c < chunk_count; c++) {
+        free_edge_list(&parts[c]);
     }
- 
-    fclose(file);
+    free(parts);
+    free(chunks);
     return adj_list;
 }
 
 void print_adjlist(t_adj_list adj_list) {
-    if (adj_list.list == NULL) {
+    if (adj_list.offsets == NULL) {
         printf("La liste est nulle.\n");
         return;
     }
 
     for (int i = 0; i < adj_list.length; i++) {
         printf("Liste pour le sommet %d  :", i+1);
-        display_list(adj_list.list[i]);
+        display_list(adj_list, i);
         printf("\n");
     }  
     printf("\n");
@@ -129,11 +431,9 @@ void report_markov(t_adj_list adj_list){
     for(int i=0; i < adj_list.length; i++) {
         
         double sum = 0;
-        t_cell *curr = adj_list.list[i].head;
 
-        while(curr !=NULL ) {
-            sum += curr->proba;
-            curr = curr->next;
+        for (int e = adj_list.offsets[i]; e < adj_list.offsets[i + 1]; e++) {
+            sum += adj_list.proba[e];
         }
 
         if (sum < 0.99 || sum > 1.01){
@@ -147,7 +447,7 @@ void report_markov(t_adj_list adj_list){
 }
 
 void write_mermaid(t_adj_list *adj_list, FILE *file) {
-    if (adj_list == NULL || adj_list->list == NULL || file == NULL) {
+    if (adj_list == NULL || adj_list->offsets == NULL || file == NULL) {
         fprintf(stderr, "Liste d'adjacence ou flux de fichier invalide.\n");
         return;
     }
@@ -170,20 +470,17 @@ void write_mermaid(t_adj_list *adj_list, FILE *file) {
     }
 
     for (int i = 0; i < adj_list->length; i++) {
-        t_cell *curr = adj_list->list[i].head;
-        
         char *from_id = getID(i + 1);
         
         if (from_id != NULL) {
-            while (curr != NULL) {
-                char *to_id = getID(curr->dest + 1);
+            for (int e = adj_list->offsets[i]; e < adj_list->offsets[i + 1]; e++) {
+                char *to_id = getID(adj_list->dest[e] + 1);
                 
                 if (to_id != NULL) {
                     fprintf(file, "%s-->|%.2f|%s\n", 
-                            from_id, curr->proba, to_id);
+                            from_id, adj_list->proba[e], to_id);
                     free(to_id);
                 }
-                curr = curr->next;
             }
             free(from_id);
         }
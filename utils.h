@@ -5,22 +5,24 @@
 #include <stdlib.h>
 #include <string.h>
 
-// Structure d'une arête 
-typedef struct s_cell {
-    int dest;               // Sommet de destination
-    float proba;            // Poid de l'arrête (probabilité)
-    struct s_cell *next;    // Pointeur vers l'arête suivante
-} t_cell;
-
-// Structure de la liste des voisins d'un sommet
-typedef struct s_list {
-    t_cell *head;          // Pointeur vers la tête de la liste chaînée
-} t_list;
-
-// Structure principale du graphe, liste d'adjacence
+// Tableau dynamique d'arêtes (format "from/to/proba" tel que lu dans le fichier)
+typedef struct s_edge_list {
+    int count;              // Nombre d'arêtes stockées
+    int capacity;           // Capacité actuelle des tableaux
+    int *from;              // Sommets de départ
+    int *dest;              // Sommets de destination
+    float *proba;           // Poids des arêtes (probabilités)
+} t_edge_list;
+
+// Structure principale du graphe, format CSR (Compressed Sparse Row) :
+// les arêtes du sommet i occupent les cases [offsets[i], offsets[i+1]) de dest et proba
 typedef struct s_adj_list {
-    int length;            // Nombre total de sommets
-    t_list *list;          // Tableau des listes d'adjacence
+    int length;             // Nombre total de sommets
+    int edge_count;         // Nombre total d'arêtes
+    int *offsets;           // Tableau de length + 1 offsets de lignes
+    int *dest;              // Destinations des arêtes, contiguës
+    float *proba;           // Probabilités des arêtes, contiguës
+    void *storage;          // Fichier projeté contenant les tableaux (NULL s'ils sont alloués), lecture seule
 } t_adj_list;
 
 /**
@@ -31,36 +33,80 @@ typedef struct s_adj_list {
 char *getID(int);
 
 /**
- * @brief Crée une nouvelle cellule (arête) pour la liste chaînée.
- * @param dest L'index du sommet de destination.
- * @param proba La probabilité de transition.
- * @return Un pointeur vers la nouvelle cellule allouée.
+ * @brief Initialise un tableau d'arêtes vide.
+ * @param initial_capacity Capacité initiale (nombre d'arêtes).
+ * @return Une structure t_edge_list vide.
  */
-t_cell *create_cell(int, float);
+t_edge_list create_edge_list(int);
 
 /**
- * @brief Initialise une liste vide.
- * @return Une structure t_list avec head = NULL.
+ * @brief Ajoute une arête à la fin du tableau (agrandi si nécessaire).
+ * @param edges Pointeur vers le tableau d'arêtes.
+ * @param from Sommet de départ (index à partir de 0).
+ * @param dest Sommet de destination (index à partir de 0).
+ * @param proba Probabilité de l'arête.
  */
-t_list create_empty_list(void);
+void edge_list_add(t_edge_list *, int, int, float);
 
 /**
- * @brief Ajoute une arête en tête d'une liste donnée.
- * @param L Pointeur vers la liste à modifier.
- * @param dest Destination de l'arête.
- * @param proba Probabilité de l'arête.
+ * @brief Libère la mémoire d'un tableau d'arêtes.
+ * @param edges Pointeur vers le tableau à libérer.
  */
-void list_add_front(t_list *, int, float);
+void free_edge_list(t_edge_list *);
 
 /**
  * @brief Crée et initialise une structure de graphe (liste d'adjacence).
  * @param length Le nombre de sommets du graphe.
- * @return Une structure t_adj_list avec 'length' listes vides.
+ * @return Une structure t_adj_list de 'length' sommets sans arête.
  */
 t_adj_list create_empty_adjlist(int);
 
+/**
+ * @brief Construit le graphe CSR à partir d'un tableau d'arêtes (tri par comptage).
+ * L'ordre des arêtes d'un même sommet est celui du tableau.
+ * @param length Le nombre de sommets du graphe.
+ * @param edges Pointeur vers le tableau d'arêtes (index à partir de 0).
+ * @return La structure t_adj_list compressée.
+ */
+t_adj_list build_adjlist(int, t_edge_list *);
+
+/**
+ * @brief Construit le graphe CSR à partir de plusieurs tableaux d'arêtes (tri par comptage parallèle).
+ * Les arêtes d'un même sommet sont rangées dans l'ordre des tableaux, puis dans l'ordre de chaque tableau.
+ * @param length Le nombre de sommets du graphe.
+ * @param parts Les tableaux d'arêtes (index à partir de 0).
+ * @param part_count Le nombre de tableaux.
+ * @return La structure t_adj_list compressée.
+ */
+t_adj_list build_adjlist_parts(int, t_edge_list *, int);
+
+/**
+ * @brief Construit le graphe transposé (toutes les arêtes inversées, mêmes probabilités).
+ * Les arêtes entrantes de chaque sommet sont rangées par sommet de départ croissant.
+ * @param adj_list Pointeur vers le graphe.
+ * @return Le graphe transposé (à libérer avec free_adjlist).
+ */
+t_adj_list transpose_adjlist(t_adj_list *);
+
+/**
+ * @brief Découpe les sommets en blocs consécutifs de poids (sommets + arêtes) équilibré,
+ * pour répartir un parcours des lignes du graphe entre les tâches du pool.
+ * @param graph Pointeur vers le graphe.
+ * @param block_count Nombre de blocs.
+ * @return Le premier sommet de chaque bloc (block_count + 1 cases, à libérer).
+ */
+int *balanced_blocks(const t_adj_list *, int);
+
+/**
+ * @brief Libère la mémoire allouée pour le graphe.
+ * @param adj_list Pointeur vers le graphe à libérer.
+ */
+void free_adjlist(t_adj_list *);
+
 /**
  * @brief Lit un fichier texte pour construire le graphe.
+ * Le fichier est projeté en mémoire, découpé en morceaux analysés en parallèle
+ * (sans fscanf) ; une ligne mal formée arrête le programme avec son numéro de ligne.
  * @param filename Le chemin du fichier contenant la description du graphe.
  * @return La structure t_adj_list complétée.
  */